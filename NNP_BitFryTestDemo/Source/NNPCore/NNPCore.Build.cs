@@ -0,0 +1,15 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+using UnrealBuildTool;
+
+// Engine-free game logic: everything here builds against Core alone, so it can be
+// unit tested by the NNPCoreTests program on any host.
+public class NNPCore : ModuleRules
+{
+	public NNPCore(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(new string[] { "Core" });
+	}
+}
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NNPFixedStepper.h"
+
+FNNPFixedStepper::FNNPFixedStepper(float stepRate, int32 maxSubSteps)
+{
+	SetRate(stepRate, maxSubSteps);
+}
+
+void FNNPFixedStepper::SetRate(float stepRate, int32 maxSubSteps)
+{
+	StepSeconds = 1.0 / FMath::Max(stepRate, 1.0f);
+	MaxSubSteps = FMath::Max(maxSubSteps, 1);
+	Reset();
+}
+
+void FNNPFixedStepper::Reset()
+{
+	Accumulator = 0.0;
+}
+
+int32 FNNPFixedStepper::Advance(float deltaSeconds, TFunctionRef<void(float stepSeconds)> step)
+{
+	int64 numOwed;
+	int32 numSteps;
+	int32 i;
+
+	Accumulator += FMath::Max(deltaSeconds, 0.0f);
+	// A step only runs once all of its time has passed, never early.
+	numOwed = (int64)FMath::FloorToDouble(Accumulator / StepSeconds);
+	if(numOwed <= 0)
+		return 0;
+
+	Accumulator -= numOwed * StepSeconds;
+
+	numSteps = (int32)FMath::Min(numOwed, (int64)MaxSubSteps);
+	for(i = 0; i < numSteps; i++)
+		step((float)StepSeconds);
+
+	// Catch up on the rest of a hitch in one go rather than dropping it.
+	if(numOwed > numSteps)
+	{
+		step((float)((numOwed - numSteps) * StepSeconds));
+		numSteps++;
+	}
+
+	return numSteps;
+}
+
+float FNNPFixedStepper::GetAlpha() const
+{
+	return FMath::Clamp((float)(Accumulator / StepSeconds), 0.0f, 1.0f);
+}
+
+float FNNPFixedStepper::GetStepSeconds() const
+{
+	return (float)StepSeconds;
+}
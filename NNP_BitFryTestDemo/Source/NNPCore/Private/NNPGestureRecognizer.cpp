@@ -0,0 +1,224 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NNPGestureRecognizer.h"
+
+FNNPGestureRecognizer::FNNPGestureRecognizer()
+{
+	TapMaxDuration = 0.25f;
+	TapSlop = 20.0f;
+	DoubleTapInterval = 0.3f;
+	DoubleTapSlop = 40.0f;
+	SwipeMinDistance = 80.0f;
+	SwipeMaxDuration = 0.5f;
+	HoldDuration = 0.5f;
+	PinchMinChange = 0.02f;
+
+	Reset();
+}
+
+void FNNPGestureRecognizer::Reset()
+{
+	int i;
+
+	for(i = 0; i < MAX_GESTURE_TOUCHES; i++)
+	{
+		Touches[i].Down = false;
+		Touches[i].Moved = false;
+		Touches[i].Consumed = false;
+		Touches[i].StartPos = {0.0f, 0.0f};
+		Touches[i].Pos = {0.0f, 0.0f};
+		Touches[i].StartTime = 0.0;
+	}
+
+	for(i = 0; i < MAX_GESTURES; i++)
+	{
+		Latency[i].Count = 0;
+		Latency[i].TotalSeconds = 0.0;
+		Latency[i].MaxSeconds = 0.0;
+	}
+
+	HasLastTap = false;
+	LastTapPos = {0.0f, 0.0f};
+	LastTapTime = 0.0;
+	Pinching = false;
+	PinchDistance = 0.0f;
+	EventHead = 0;
+	EventCount = 0;
+}
+
+void FNNPGestureRecognizer::AddSample(int32 finger, bool pressed, FVector2D position, double time)
+{
+	// Fingers beyond the second can't form any of our gestures.
+	if(finger < 0 || finger >= MAX_GESTURE_TOUCHES)
+		return;
+
+	TouchState &touch = Touches[finger];
+
+	if(pressed && !touch.Down)
+	{
+		touch.Down = true;
+		touch.Moved = false;
+		touch.Consumed = false;
+		touch.StartPos = position;
+		touch.Pos = position;
+		touch.StartTime = time;
+	}
+	else if(pressed)
+	{
+		touch.Pos = position;
+		if(!touch.Moved && FVector2D::DistSquared(touch.StartPos, position) > TapSlop * TapSlop)
+			touch.Moved = true;
+	}
+	else if(touch.Down)
+	{
+		touch.Pos = position;
+		TouchReleased(touch, time);
+	}
+
+	UpdatePinch(time);
+	Update(time);
+}
+
+void FNNPGestureRecognizer::Update(double time)
+{
+	int i;
+
+	for(i = 0; i < MAX_GESTURE_TOUCHES; i++)
+	{
+		TouchState &touch = Touches[i];
+
+		if(!touch.Down || touch.Moved || touch.Consumed)
+			continue;
+
+		if(time - touch.StartTime >= HoldDuration)
+		{
+			touch.Consumed = true;
+			// A hold becomes recognizable the moment the duration runs out.
+			PushEvent(Hold_Gesture, touch.Pos, touch.StartTime + HoldDuration);
+		}
+	}
+}
+
+void FNNPGestureRecognizer::TouchReleased(TouchState &touch, double time)
+{
+	float duration = (float)(time - touch.StartTime);
+	FVector2D delta = touch.Pos - touch.StartPos;
+
+	touch.Down = false;
+
+	if(touch.Consumed)
+		return;
+
+	if(!touch.Moved && duration <= TapMaxDuration)
+	{
+		// Every tap is reported straight away.  One that pairs with the last tap is
+		// also a double tap, and starts over so a third tap doesn't pair again.
+		PushEvent(Tap_Gesture, touch.Pos, time);
+
+		if(HasLastTap && time - LastTapTime <= DoubleTapInterval && FVector2D::DistSquared(LastTapPos, touch.Pos) <= DoubleTapSlop * DoubleTapSlop)
+		{
+			HasLastTap = false;
+			PushEvent(DoubleTap_Gesture, touch.Pos, time);
+		}
+		else
+		{
+			HasLastTap = true;
+			LastTapPos = touch.Pos;
+			LastTapTime = time;
+		}
+	}
+	else if(duration <= SwipeMaxDuration && delta.SizeSquared() >= SwipeMinDistance * SwipeMinDistance)
+	{
+		GestureEvent &event = PushEvent(Swipe_Gesture, touch.StartPos, time);
+		event.Direction = delta.GetSafeNormal();
+	}
+}
+
+void FNNPGestureRecognizer::UpdatePinch(double time)
+{
+	float distance;
+	float scale;
+
+	if(!Touches[0].Down || !Touches[1].Down)
+	{
+		Pinching = false;
+		return;
+	}
+
+	distance = FVector2D::Distance(Touches[0].Pos, Touches[1].Pos);
+
+	if(!Pinching)
+	{
+		// Both fingers belong to the pinch now, not to taps, holds or swipes.
+		Pinching = true;
+		PinchDistance = distance;
+		Touches[0].Consumed = true;
+		Touches[1].Consumed = true;
+		return;
+	}
+
+	if(PinchDistance <= KINDA_SMALL_NUMBER)
+	{
+		PinchDistance = distance;
+		return;
+	}
+
+	scale = distance / PinchDistance;
+	if(FMath::Abs(scale - 1.0f) < PinchMinChange)
+		return;
+
+	GestureEvent &event = PushEvent(Pinch_Gesture, (Touches[0].Pos + Touches[1].Pos) * 0.5f, time);
+	event.PinchScale = scale;
+	PinchDistance = distance;
+}
+
+GestureEvent& FNNPGestureRecognizer::PushEvent(NNPGestures type, FVector2D position, double time)
+{
+	int32 index;
+
+	// Anything else recognized between two taps keeps them from pairing.
+	if(type != Tap_Gesture && type != DoubleTap_Gesture)
+		HasLastTap = false;
+
+	// When the queue is full the oldest gesture is dropped; it is stale by now anyway.
+	if(EventCount == MAX_GESTURE_EVENTS)
+	{
+		EventHead = (EventHead + 1) % MAX_GESTURE_EVENTS;
+		EventCount--;
+	}
+
+	index = (EventHead + EventCount) % MAX_GESTURE_EVENTS;
+	EventCount++;
+
+	Events[index].Type = type;
+	Events[index].Position = position;
+	Events[index].Direction = {0.0f, 0.0f};
+	Events[index].PinchScale = 1.0f;
+	Events[index].SampleTime = time;
+
+	return Events[index];
+}
+
+bool FNNPGestureRecognizer::PopEvent(GestureEvent &event, double time)
+{
+	double latency;
+
+	if(EventCount == 0)
+		return false;
+
+	event = Events[EventHead];
+	EventHead = (EventHead + 1) % MAX_GESTURE_EVENTS;
+	EventCount--;
+
+	latency = FMath::Max(0.0, time - event.SampleTime);
+	Latency[event.Type].Count++;
+	Latency[event.Type].TotalSeconds += latency;
+	Latency[event.Type].MaxSeconds = FMath::Max(Latency[event.Type].MaxSeconds, latency);
+
+	return true;
+}
+
+const GestureLatency& FNNPGestureRecognizer::GetLatency(NNPGestures gesture) const
+{
+	return Latency[gesture];
+}
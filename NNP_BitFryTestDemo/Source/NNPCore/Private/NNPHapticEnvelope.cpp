@@ -0,0 +1,139 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NNPHapticEnvelope.h"
+
+// Loudness that maps to zero intensity.  Full scale maps to one.
+#define ENVELOPE_FLOOR_DB -48.0f
+// Time for intensity to fall by ENVELOPE_FLOOR_DB once the sound stops.
+#define ENVELOPE_RELEASE_SECONDS 0.08f
+// Zero crossing rates that map to zero and full sharpness.
+#define ENVELOPE_DULL_HZ 80.0f
+#define ENVELOPE_BRIGHT_HZ 4000.0f
+
+static uint8 Quantize(float value)
+{
+	return (uint8)FMath::RoundToInt(FMath::Clamp(value, 0.0f, 1.0f) * 255.0f);
+}
+
+FNNPHapticEnvelope::FNNPHapticEnvelope() : FrameRate(HAPTIC_ENVELOPE_DEFAULT_RATE)
+{
+}
+
+int32 FNNPHapticEnvelope::NumFrames() const
+{
+	return FMath::Min(Intensity.Num(), Sharpness.Num());
+}
+
+float FNNPHapticEnvelope::GetDuration() const
+{
+	return FrameRate > 0.0f ? NumFrames() / FrameRate : 0.0f;
+}
+
+void FNNPHapticEnvelope::Sample(float time, float &intensity, float &sharpness) const
+{
+	int32 numFrames = NumFrames();
+	float position = time * FrameRate;
+	int32 frame = FMath::FloorToInt(position);
+	int32 next;
+	float alpha;
+
+	if(numFrames == 0 || frame < 0 || frame >= numFrames)
+	{
+		intensity = 0.0f;
+		sharpness = 0.0f;
+		return;
+	}
+
+	next = FMath::Min(frame + 1, numFrames - 1);
+	alpha = position - frame;
+
+	intensity = FMath::Lerp((float)Intensity[frame], (float)Intensity[next], alpha) / 255.0f;
+	sharpness = FMath::Lerp((float)Sharpness[frame], (float)Sharpness[next], alpha) / 255.0f;
+}
+
+bool FNNPHapticEnvelope::Extract(const int16 *samples, int32 numFrames, int32 numChannels, int32 sampleRate, float frameRate, FNNPHapticEnvelope &envelope)
+{
+	int32 window;
+	int32 numOut;
+	int32 lastAudible = INDEX_NONE;
+	float release;
+	float level = 0.0f;
+	float sharpness = 0.0f;
+	int32 i;
+
+	envelope.Intensity.Reset();
+	envelope.Sharpness.Reset();
+
+	if(!samples || numFrames <= 0 || numChannels <= 0 || sampleRate <= 0 || frameRate <= 0.0f)
+		return false;
+
+	window = FMath::Max(FMath::RoundToInt(sampleRate / frameRate), 1);
+	numOut = FMath::DivideAndRoundUp(numFrames, window);
+	// Per output frame, so the decay takes the same time at any frame rate.
+	release = 1.0f / (ENVELOPE_RELEASE_SECONDS * frameRate);
+
+	envelope.FrameRate = frameRate;
+	envelope.Intensity.SetNumUninitialized(numOut);
+	envelope.Sharpness.SetNumUninitialized(numOut);
+
+	for(i = 0; i < numOut; i++)
+	{
+		int32 start = i * window;
+		int32 count = FMath::Min(window, numFrames - start);
+		double sumSquares = 0.0;
+		int32 crossings = 0;
+		float previous = 0.0f;
+		float loudness;
+		int32 j;
+
+		for(j = 0; j < count; j++)
+		{
+			const int16 *frame = samples + (int64)(start + j) * numChannels;
+			float mono = 0.0f;
+			int32 c;
+
+			for(c = 0; c < numChannels; c++)
+				mono += frame[c];
+			mono /= numChannels * 32768.0f;
+
+			sumSquares += mono * mono;
+			if(j > 0 && (mono >= 0.0f) != (previous >= 0.0f))
+				crossings++;
+			previous = mono;
+		}
+
+		// Decibels, with the floor at zero and full scale at one.
+		loudness = 10.0f * FMath::LogX(10.0f, FMath::Max((float)(sumSquares / count), SMALL_NUMBER));
+		loudness = FMath::Clamp(1.0f - loudness / ENVELOPE_FLOOR_DB, 0.0f, 1.0f);
+
+		// Jump straight up to attacks, fall off linearly after them.
+		level = FMath::Max(loudness, level - release);
+
+		// Silence has no pitch; hold the last sharpness through it.
+		if(loudness > 0.0f && count > 1)
+		{
+			float hz = crossings * sampleRate / (2.0f * (count - 1));
+			sharpness = FMath::Clamp(FMath::LogX(ENVELOPE_BRIGHT_HZ / ENVELOPE_DULL_HZ, FMath::Max(hz, 1.0f) / ENVELOPE_DULL_HZ), 0.0f, 1.0f);
+		}
+
+		envelope.Intensity[i] = Quantize(level);
+		envelope.Sharpness[i] = Quantize(sharpness);
+
+		if(envelope.Intensity[i] > 0)
+			lastAudible = i;
+	}
+
+	// Drop the silent tail; it would only keep a voice busy.
+	envelope.Intensity.SetNum(lastAudible + 1);
+	envelope.Sharpness.SetNum(lastAudible + 1);
+
+	return true;
+}
+
+FArchive& operator<<(FArchive &Ar, FNNPHapticEnvelope &envelope)
+{
+	Ar << envelope.FrameRate;
+	Ar << envelope.Intensity;
+	Ar << envelope.Sharpness;
+	return Ar;
+}
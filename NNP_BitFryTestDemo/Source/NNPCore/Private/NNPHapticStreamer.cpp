@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NNPHapticStreamer.h"
+
+FNNPHapticStreamer::FNNPHapticStreamer()
+{
+	IdleSharpness = 0.5f;
+	BaseIntensity = 0.0f;
+	BaseSharpness = IdleSharpness;
+
+	StopAll();
+
+	LastIntensity = -1;
+	LastSharpness = -1;
+}
+
+void FNNPHapticStreamer::Play(const FNNPHapticEnvelope *envelope, float gain)
+{
+	int32 slot = 0;
+	int32 i;
+
+	if(!envelope || envelope->NumFrames() == 0 || gain <= 0.0f)
+		return;
+
+	for(i = 0; i < MAX_HAPTIC_VOICES; i++)
+	{
+		if(!Voices[i].Envelope)
+		{
+			slot = i;
+			break;
+		}
+
+		if(Voices[i].Time > Voices[slot].Time)
+			slot = i;
+	}
+
+	Voices[slot].Envelope = envelope;
+	Voices[slot].Time = 0.0f;
+	Voices[slot].Gain = FMath::Min(gain, 1.0f);
+}
+
+void FNNPHapticStreamer::StopAll()
+{
+	int32 i;
+
+	for(i = 0; i < MAX_HAPTIC_VOICES; i++)
+	{
+		Voices[i].Envelope = nullptr;
+		Voices[i].Time = 0.0f;
+		Voices[i].Gain = 0.0f;
+	}
+}
+
+bool FNNPHapticStreamer::IsPlaying() const
+{
+	int32 i;
+
+	for(i = 0; i < MAX_HAPTIC_VOICES; i++)
+	{
+		if(Voices[i].Envelope)
+			return true;
+	}
+
+	return false;
+}
+
+void FNNPHapticStreamer::SetBaseLevel(float intensity, float sharpness)
+{
+	BaseIntensity = FMath::Clamp(intensity, 0.0f, 1.0f);
+	BaseSharpness = FMath::Clamp(sharpness, 0.0f, 1.0f);
+}
+
+void FNNPHapticStreamer::Update(float deltaSeconds, INNPHapticsBackend *backend)
+{
+	float intensity = BaseIntensity;
+	float sharpness = BaseIntensity > 0.0f ? BaseSharpness : IdleSharpness;
+	int32 quantizedIntensity;
+	int32 quantizedSharpness;
+	int32 i;
+
+	for(i = 0; i < MAX_HAPTIC_VOICES; i++)
+	{
+		HapticVoice &voice = Voices[i];
+		float voiceIntensity;
+		float voiceSharpness;
+
+		if(!voice.Envelope)
+			continue;
+
+		// Sample first so the opening frame of a new envelope is never skipped.
+		if(voice.Time >= voice.Envelope->GetDuration())
+		{
+			voice.Envelope = nullptr;
+			continue;
+		}
+
+		voice.Envelope->Sample(voice.Time, voiceIntensity, voiceSharpness);
+		voice.Time += deltaSeconds;
+
+		voiceIntensity *= voice.Gain;
+		if(voiceIntensity > intensity)
+		{
+			intensity = voiceIntensity;
+			sharpness = voiceSharpness;
+		}
+	}
+
+	quantizedIntensity = FMath::RoundToInt(intensity * 255.0f);
+	quantizedSharpness = FMath::RoundToInt(sharpness * 255.0f);
+
+	// Sharpness can't be felt at zero intensity, so it doesn't count as a change there.
+	if(quantizedIntensity == LastIntensity && (quantizedIntensity == 0 || quantizedSharpness == LastSharpness))
+		return;
+
+	LastIntensity = quantizedIntensity;
+	LastSharpness = quantizedSharpness;
+
+	if(backend)
+		backend->UpdateHaptics(quantizedIntensity / 255.0f, quantizedSharpness / 255.0f);
+}
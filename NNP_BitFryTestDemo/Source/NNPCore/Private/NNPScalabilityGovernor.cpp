@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NNPScalabilityGovernor.h"
+
+FNNPScalabilityGovernor::FNNPScalabilityGovernor(const FNNPGovernorSettings& settings) : Settings(settings)
+{
+	Settings.MaxLevel = FMath::Clamp(Settings.MaxLevel, 0, (int32)UE_ARRAY_COUNT(UpshiftBackoff) - 1);
+	Reset();
+}
+
+void FNNPScalabilityGovernor::Reset()
+{
+	int i;
+
+	Level = 0;
+	SmoothedFrameMs = 0.0f;
+	SmoothedGameThreadMs = 0.0f;
+	bHasSamples = false;
+	OverBudgetFrames = 0;
+	UnderBudgetFrames = 0;
+	SettleFramesLeft = 0;
+	FramesSinceUpshift = MAX_int32;
+
+	for(i = 0; i < (int)UE_ARRAY_COUNT(UpshiftBackoff); i++)
+		UpshiftBackoff[i] = 1;
+}
+
+bool FNNPScalabilityGovernor::Sample(float frameTimeMs, float gameThreadTimeMs)
+{
+	if(!bHasSamples)
+	{
+		SmoothedFrameMs = frameTimeMs;
+		SmoothedGameThreadMs = gameThreadTimeMs;
+		bHasSamples = true;
+	}
+	else
+	{
+		SmoothedFrameMs += (frameTimeMs - SmoothedFrameMs) * Settings.SmoothingFactor;
+		SmoothedGameThreadMs += (gameThreadTimeMs - SmoothedGameThreadMs) * Settings.SmoothingFactor;
+	}
+
+	if(FramesSinceUpshift < MAX_int32)
+		FramesSinceUpshift++;
+
+	if(SettleFramesLeft > 0)
+	{
+		SettleFramesLeft--;
+		return false;
+	}
+
+	if(SmoothedFrameMs > Settings.TargetFrameTimeMs * Settings.DownshiftRatio)
+	{
+		OverBudgetFrames++;
+		UnderBudgetFrames = 0;
+	}
+	else if(SmoothedGameThreadMs < Settings.TargetFrameTimeMs * Settings.UpshiftRatio)
+	{
+		UnderBudgetFrames++;
+		OverBudgetFrames = 0;
+	}
+	else
+	{
+		OverBudgetFrames = 0;
+		UnderBudgetFrames = 0;
+	}
+
+	if(OverBudgetFrames >= Settings.DownshiftFrames && Level < Settings.MaxLevel)
+	{
+		// Dropping straight back down after an upshift means the better level
+		// can't be held here; wait longer before trying it again.
+		if(FramesSinceUpshift < Settings.UpshiftFrames)
+			UpshiftBackoff[Level] = FMath::Min(UpshiftBackoff[Level] * 2, MAX_UPSHIFT_BACKOFF);
+
+		Level++;
+		OverBudgetFrames = 0;
+		UnderBudgetFrames = 0;
+		SettleFramesLeft = Settings.SettleFrames;
+		FramesSinceUpshift = MAX_int32;
+		return true;
+	}
+
+	if(Level > 0 && UnderBudgetFrames >= Settings.UpshiftFrames * UpshiftBackoff[Level - 1])
+	{
+		Level--;
+		OverBudgetFrames = 0;
+		UnderBudgetFrames = 0;
+		SettleFramesLeft = Settings.SettleFrames;
+		FramesSinceUpshift = 0;
+		return true;
+	}
+
+	return false;
+}
+
+int32 FNNPScalabilityGovernor::GetLevel() const
+{
+	return Level;
+}
+
+float FNNPScalabilityGovernor::GetSmoothedFrameTimeMs() const
+{
+	return SmoothedFrameMs;
+}
+
+float FNNPScalabilityGovernor::GetSmoothedGameThreadTimeMs() const
+{
+	return SmoothedGameThreadMs;
+}
+
+int32 FNNPScalabilityGovernor::GetUpshiftBackoff(int32 level) const
+{
+	if(level < 0 || level >= (int32)UE_ARRAY_COUNT(UpshiftBackoff))
+		return 1;
+
+	return UpshiftBackoff[level];
+}
+
+const FNNPGovernorSettings& FNNPScalabilityGovernor::GetSettings() const
+{
+	return Settings;
+}
@@ -0,0 +1,165 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NNPCoreTests.h"
+#include "NNPFixedStepper.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Input changes on these boundaries, which every tested frame rate lands on.
+#define INPUT_PERIOD 0.5
+#define TRACE_SECONDS 6.0f
+
+// Stand-in for the character: turn, then accelerate along the facing with
+// friction, the same order the character applies its input in each step.  This
+// tests the stepper's contract; the character's own step needs a world and a
+// movement component, so it isn't covered here.
+struct FStepperSim
+{
+	float X = 0.0f;
+	float Y = 0.0f;
+	float Yaw = 0.0f;
+	float VelocityX = 0.0f;
+	float VelocityY = 0.0f;
+
+	void Step(float seconds, float moveInput, float turnInput)
+	{
+		float radians;
+
+		Yaw += turnInput * 90.0f * seconds;
+		radians = FMath::DegreesToRadians(Yaw);
+
+		VelocityX += (FMath::Cos(radians) * moveInput * 2000.0f - VelocityX * 8.0f) * seconds;
+		VelocityY += (FMath::Sin(radians) * moveInput * 2000.0f - VelocityY * 8.0f) * seconds;
+		X += VelocityX * seconds;
+		Y += VelocityY * seconds;
+	}
+
+	bool operator==(const FStepperSim& other) const
+	{
+		return X == other.X && Y == other.Y && Yaw == other.Yaw && VelocityX == other.VelocityX && VelocityY == other.VelocityY;
+	}
+};
+
+// The recorded input: forward and turn axes for each INPUT_PERIOD.
+static void GetTraceInput(double time, float &moveInput, float &turnInput)
+{
+	static const float trace[][2] =
+	{
+		{ 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.5f, -1.0f }, { 0.0f, 0.0f },
+		{ -1.0f, 0.25f }, { 1.0f, 0.0f }, { 0.75f, -0.5f }, { 0.0f, 1.0f },
+	};
+	int32 index = (int32)FMath::FloorToDouble(time / INPUT_PERIOD + 0.001) % (int32)UE_ARRAY_COUNT(trace);
+
+	moveInput = trace[index][0];
+	turnInput = trace[index][1];
+}
+
+// Run the trace at a frame rate, latching input at the start of each frame the
+// way the character does, and record the state at the end of every step.
+static void RunTrace(float frameRate, int32 maxSubSteps, TArray<FStepperSim> &steps)
+{
+	FNNPFixedStepper stepper(60.0f, maxSubSteps);
+	FStepperSim sim;
+	int32 numFrames = FMath::RoundToInt(TRACE_SECONDS * frameRate);
+	int32 frame;
+
+	for(frame = 0; frame < numFrames; frame++)
+	{
+		float moveInput;
+		float turnInput;
+
+		GetTraceInput(frame / (double)frameRate, moveInput, turnInput);
+
+		stepper.Advance(1.0f / frameRate, [&](float seconds)
+		{
+			sim.Step(seconds, moveInput, turnInput);
+			steps.Add(sim);
+		});
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNNPFixedStepperDeterminismTest, "NNP.FixedStepper.Determinism", NNP_TEST_FLAGS)
+bool FNNPFixedStepperDeterminismTest::RunTest(const FString& Parameters)
+{
+	static const float frameRates[] = { 30.0f, 144.0f };
+	TArray<FStepperSim> reference;
+	int32 i;
+	int32 j;
+
+	RunTrace(60.0f, 4, reference);
+	TestEqual(TEXT("Steps at 60 Hz"), reference.Num(), (int32)(TRACE_SECONDS * 60.0f));
+
+	for(i = 0; i < (int32)UE_ARRAY_COUNT(frameRates); i++)
+	{
+		TArray<FStepperSim> steps;
+
+		RunTrace(frameRates[i], 4, steps);
+
+		if(!TestEqual(FString::Printf(TEXT("Steps at %.0f Hz"), frameRates[i]), steps.Num(), reference.Num()))
+			continue;
+
+		for(j = 0; j < steps.Num(); j++)
+		{
+			if(!(steps[j] == reference[j]))
+			{
+				AddError(FString::Printf(TEXT("At %.0f Hz, step %d ends at (%f, %f) yaw %f; at 60 Hz it ends at (%f, %f) yaw %f"), frameRates[i], j,
+					steps[j].X, steps[j].Y, steps[j].Yaw, reference[j].X, reference[j].Y, reference[j].Yaw));
+				break;
+			}
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNNPFixedStepperHitchTest, "NNP.FixedStepper.Hitch", NNP_TEST_FLAGS)
+bool FNNPFixedStepperHitchTest::RunTest(const FString& Parameters)
+{
+	FNNPFixedStepper stepper(60.0f, 4);
+	TArray<float> stepSeconds;
+	double simulated = 0.0;
+	int32 numSteps;
+	int32 i;
+
+	auto step = [&](float seconds)
+	{
+		stepSeconds.Add(seconds);
+		simulated += seconds;
+	};
+
+	// A quarter second hitch owes 15 steps: 4 run as usual, the other 11 as one.
+	numSteps = stepper.Advance(0.25f, step);
+
+	TestEqual(TEXT("Steps run for the hitch"), numSteps, 5);
+	TestEqual(TEXT("Step callbacks"), stepSeconds.Num(), 5);
+	for(i = 0; i < 4 && i < stepSeconds.Num(); i++)
+		TestEqual(FString::Printf(TEXT("Step %d length"), i), stepSeconds[i], 1.0f / 60.0f, 1.e-6f);
+	if(stepSeconds.Num() == 5)
+		TestEqual(TEXT("Catch-up step length"), stepSeconds[4], 11.0f / 60.0f, 1.e-6f);
+	TestEqual(TEXT("Time simulated for the hitch"), simulated, 0.25, 1.e-6);
+
+	// Nothing is dropped: the steady frames after it carry on from where it left off.
+	// The catch-up step makes the result frame rate dependent from here, though.
+	for(i = 0; i < 60; i++)
+		stepper.Advance(1.0f / 60.0f, step);
+
+	TestEqual(TEXT("Time simulated after the hitch"), simulated, 1.25, 1.e-5);
+	TestEqual(TEXT("Steps in total"), stepSeconds.Num(), 65);
+
+	// Leftover time carries into the next frame and shows up as the draw alpha.
+	stepper.Reset();
+	stepSeconds.Reset();
+	TestEqual(TEXT("Steps for a short frame"), stepper.Advance(0.01f, step), 0);
+	TestEqual(TEXT("Alpha after a short frame"), stepper.GetAlpha(), 0.6f, 1.e-4f);
+	TestEqual(TEXT("Steps when the next frame completes the step"), stepper.Advance(0.01f, step), 1);
+	TestEqual(TEXT("Alpha after completing the step"), stepper.GetAlpha(), 0.2f, 1.e-4f);
+
+	// A step never runs before all of its time has passed, however close the frame gets.
+	stepper.Reset();
+	TestEqual(TEXT("Steps a microsecond short of a step"), stepper.Advance(1.0f / 60.0f - 1.e-6f, step), 0);
+	TestEqual(TEXT("Steps once the microsecond passes"), stepper.Advance(2.e-6f, step), 1);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,153 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NNPCoreTests.h"
+#include "NNPGestureRecognizer.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define REPLAY_FRAME_RATE 60.0
+#define LATENCY_TOLERANCE 1.e-4
+
+struct FTouchSample
+{
+	double Time;
+	int32 Finger;
+	bool Pressed;
+	float X;
+	float Y;
+};
+
+struct FExpectedGesture
+{
+	NNPGestures Type;
+	double Latency;
+	// Only checked for pinches.
+	float PinchScale;
+};
+
+// Touch samples as the platform would deliver them.  None land exactly on a
+// frame, so the latency each gesture is expected to see is unambiguous.
+static const FTouchSample TouchTrace[] =
+{
+	// A lone tap.
+	{ 0.10, 0, true, 100.0f, 100.0f },
+	{ 0.18, 0, false, 100.0f, 100.0f },
+
+	// A double tap, the second a few pixels from the first.
+	{ 1.00, 0, true, 100.0f, 100.0f },
+	{ 1.08, 0, false, 100.0f, 100.0f },
+	{ 1.20, 0, true, 105.0f, 100.0f },
+	{ 1.26, 0, false, 105.0f, 100.0f },
+
+	// A swipe to the right.
+	{ 2.01, 0, true, 100.0f, 300.0f },
+	{ 2.10, 0, true, 200.0f, 300.0f },
+	{ 2.21, 0, false, 300.0f, 300.0f },
+
+	// A hold, recognized half a second in while the finger rests.
+	{ 3.01, 0, true, 50.0f, 50.0f },
+	{ 4.00, 0, false, 50.0f, 50.0f },
+
+	// A tap straight into a swipe.
+	{ 5.01, 0, true, 100.0f, 100.0f },
+	{ 5.05, 0, false, 100.0f, 100.0f },
+	{ 5.10, 0, true, 100.0f, 300.0f },
+	{ 5.20, 0, true, 200.0f, 300.0f },
+	{ 5.31, 0, false, 300.0f, 300.0f },
+
+	// Two quick taps too far apart to be a double tap.
+	{ 6.01, 0, true, 100.0f, 100.0f },
+	{ 6.05, 0, false, 100.0f, 100.0f },
+	{ 6.15, 0, true, 400.0f, 400.0f },
+	{ 6.21, 0, false, 400.0f, 400.0f },
+
+	// Two fingers spread from 100 to 150 to 200 pixels apart, close back to 150
+	// and lift.  Neither finger is a tap, swipe or hold on the way.
+	{ 7.01, 0, true, 300.0f, 300.0f },
+	{ 7.02, 1, true, 400.0f, 300.0f },
+	{ 7.10, 1, true, 450.0f, 300.0f },
+	{ 7.20, 0, true, 250.0f, 300.0f },
+	{ 7.30, 1, true, 400.0f, 300.0f },
+	{ 7.40, 0, false, 250.0f, 300.0f },
+	{ 7.41, 1, false, 400.0f, 300.0f },
+};
+
+// Frames run at 1/60 s intervals.  A gesture's latency runs from the sample that
+// completed it to the first frame that pops it, which is never more than a frame.
+static const FExpectedGesture ExpectedGestures[] =
+{
+	{ Tap_Gesture, 11.0 / 60.0 - 0.18, 1.0f },
+	{ Tap_Gesture, 65.0 / 60.0 - 1.08, 1.0f },
+	{ Tap_Gesture, 76.0 / 60.0 - 1.26, 1.0f },
+	{ DoubleTap_Gesture, 76.0 / 60.0 - 1.26, 1.0f },
+	{ Swipe_Gesture, 133.0 / 60.0 - 2.21, 1.0f },
+	{ Hold_Gesture, 211.0 / 60.0 - 3.51, 1.0f },
+	{ Tap_Gesture, 303.0 / 60.0 - 5.05, 1.0f },
+	{ Swipe_Gesture, 319.0 / 60.0 - 5.31, 1.0f },
+	{ Tap_Gesture, 363.0 / 60.0 - 6.05, 1.0f },
+	{ Tap_Gesture, 373.0 / 60.0 - 6.21, 1.0f },
+	{ Pinch_Gesture, 426.0 / 60.0 - 7.10, 1.5f },
+	{ Pinch_Gesture, 432.0 / 60.0 - 7.20, 200.0f / 150.0f },
+	{ Pinch_Gesture, 438.0 / 60.0 - 7.30, 0.75f },
+};
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNNPGestureReplayTest, "NNP.Gestures.Replay", NNP_TEST_FLAGS)
+bool FNNPGestureReplayTest::RunTest(const FString& Parameters)
+{
+	FNNPGestureRecognizer recognizer;
+	TArray<NNPGestures> types;
+	TArray<double> latencies;
+	TArray<float> scales;
+	int32 nextSample = 0;
+	int32 frame;
+	int32 i;
+
+	// Each frame takes the samples that arrived since the last one, advances the
+	// recognizer and drains it, the way the character does.
+	for(frame = 0; frame < 8 * REPLAY_FRAME_RATE; frame++)
+	{
+		double now = frame / REPLAY_FRAME_RATE;
+		GestureEvent event;
+
+		while(nextSample < (int32)UE_ARRAY_COUNT(TouchTrace) && TouchTrace[nextSample].Time <= now)
+		{
+			const FTouchSample& sample = TouchTrace[nextSample++];
+			recognizer.AddSample(sample.Finger, sample.Pressed, FVector2D(sample.X, sample.Y), sample.Time);
+		}
+
+		recognizer.Update(now);
+
+		while(recognizer.PopEvent(event, now))
+		{
+			types.Add(event.Type);
+			latencies.Add(now - event.SampleTime);
+			scales.Add(event.PinchScale);
+		}
+	}
+
+	if(!TestEqual(TEXT("Gestures recognized"), types.Num(), (int32)UE_ARRAY_COUNT(ExpectedGestures)))
+	{
+		for(i = 0; i < types.Num(); i++)
+			AddError(FString::Printf(TEXT("Gesture %d: type %d after %.1f ms"), i, (int32)types[i], latencies[i] * 1000.0));
+		return false;
+	}
+
+	for(i = 0; i < types.Num(); i++)
+	{
+		TestEqual(FString::Printf(TEXT("Gesture %d type"), i), (int32)types[i], (int32)ExpectedGestures[i].Type);
+		TestEqual(FString::Printf(TEXT("Gesture %d latency"), i), latencies[i], ExpectedGestures[i].Latency, LATENCY_TOLERANCE);
+		if(ExpectedGestures[i].Type == Pinch_Gesture)
+			TestEqual(FString::Printf(TEXT("Gesture %d pinch scale"), i), scales[i], ExpectedGestures[i].PinchScale, 1.e-4f);
+	}
+
+	// The recognizer's own latency stats agree with what the frames saw, and no
+	// tap waits on a double tap.
+	TestEqual(TEXT("Taps counted"), recognizer.GetLatency(Tap_Gesture).Count, 6);
+	TestEqual(TEXT("Double taps counted"), recognizer.GetLatency(DoubleTap_Gesture).Count, 1);
+	TestEqual(TEXT("Pinches counted"), recognizer.GetLatency(Pinch_Gesture).Count, 3);
+	TestTrue(TEXT("Taps are handled within a frame"), recognizer.GetLatency(Tap_Gesture).MaxSeconds <= 1.0 / REPLAY_FRAME_RATE + LATENCY_TOLERANCE);
+
+	return true;
+}
+
+#endif
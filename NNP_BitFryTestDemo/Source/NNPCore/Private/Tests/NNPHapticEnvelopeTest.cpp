@@ -0,0 +1,170 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NNPCoreTests.h"
+#include "NNPHapticEnvelope.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define TEST_SAMPLE_RATE 48000
+#define TEST_FRAME_RATE 60.0f
+
+// One byte per frame, so values are only good to a quantization step.
+#define ENVELOPE_TOLERANCE (1.5f / 255.0f)
+
+// Interleaved stereo sine, the same on both channels.
+static void MakeTone(float hz, float amplitude, float seconds, TArray<int16> &samples)
+{
+	int32 numFrames = FMath::RoundToInt(seconds * TEST_SAMPLE_RATE);
+	int32 i;
+
+	samples.SetNumUninitialized(numFrames * 2);
+	for(i = 0; i < numFrames; i++)
+	{
+		int16 value = (int16)FMath::RoundToInt(FMath::Sin(2.0f * PI * hz * i / TEST_SAMPLE_RATE) * amplitude * 32767.0f);
+
+		samples[i * 2] = value;
+		samples[i * 2 + 1] = value;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNNPHapticEnvelopeSilenceTest, "NNP.Haptics.Envelope.ExtractSilence", NNP_TEST_FLAGS)
+bool FNNPHapticEnvelopeSilenceTest::RunTest(const FString& Parameters)
+{
+	TArray<int16> samples;
+	FNNPHapticEnvelope envelope;
+
+	samples.SetNumZeroed(TEST_SAMPLE_RATE * 2);
+
+	// Silence is valid audio; it just has nothing to feel, and the silent tail is dropped.
+	TestTrue(TEXT("Extracts"), FNNPHapticEnvelope::Extract(samples.GetData(), TEST_SAMPLE_RATE, 2, TEST_SAMPLE_RATE, TEST_FRAME_RATE, envelope));
+	TestEqual(TEXT("Frames"), envelope.NumFrames(), 0);
+	TestEqual(TEXT("Duration"), envelope.GetDuration(), 0.0f);
+
+	// No audio at all is not.
+	TestFalse(TEXT("Extracts nothing"), FNNPHapticEnvelope::Extract(samples.GetData(), 0, 2, TEST_SAMPLE_RATE, TEST_FRAME_RATE, envelope));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNNPHapticEnvelopeImpulseTest, "NNP.Haptics.Envelope.ExtractImpulse", NNP_TEST_FLAGS)
+bool FNNPHapticEnvelopeImpulseTest::RunTest(const FString& Parameters)
+{
+	TArray<int16> samples;
+	FNNPHapticEnvelope envelope;
+	int32 impulseFrame = 30;
+	int32 i;
+
+	// A one millisecond full-scale click half a second into a second of silence.
+	samples.SetNumZeroed(TEST_SAMPLE_RATE * 2);
+	for(i = TEST_SAMPLE_RATE / 2; i < TEST_SAMPLE_RATE / 2 + TEST_SAMPLE_RATE / 1000; i++)
+	{
+		samples[i * 2] = 32767;
+		samples[i * 2 + 1] = 32767;
+	}
+
+	TestTrue(TEXT("Extracts"), FNNPHapticEnvelope::Extract(samples.GetData(), TEST_SAMPLE_RATE, 2, TEST_SAMPLE_RATE, TEST_FRAME_RATE, envelope));
+	if(!TestTrue(TEXT("Reaches the click"), envelope.NumFrames() > impulseFrame))
+		return false;
+
+	// Silent until the click, jumps straight up on it, then falls away within the release time.
+	for(i = 0; i < impulseFrame; i++)
+		TestEqual(FString::Printf(TEXT("Frame %d before the click"), i), (int32)envelope.Intensity[i], 0);
+
+	TestTrue(TEXT("Attack"), envelope.Intensity[impulseFrame] > 0);
+	for(i = impulseFrame + 1; i < envelope.NumFrames(); i++)
+		TestTrue(FString::Printf(TEXT("Frame %d decays"), i), envelope.Intensity[i] < envelope.Intensity[i - 1]);
+
+	TestTrue(TEXT("Tail is trimmed after the release"), envelope.NumFrames() <= impulseFrame + FMath::CeilToInt(0.08f * TEST_FRAME_RATE) + 1);
+	TestTrue(TEXT("Last frame is audible"), envelope.Intensity.Last() > 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNNPHapticEnvelopeToneTest, "NNP.Haptics.Envelope.ExtractTone", NNP_TEST_FLAGS)
+bool FNNPHapticEnvelopeToneTest::RunTest(const FString& Parameters)
+{
+	TArray<int16> samples;
+	FNNPHapticEnvelope low;
+	FNNPHapticEnvelope high;
+	FNNPHapticEnvelope quiet;
+	int32 i;
+
+	// A steady tone gives a steady envelope, one frame per 60th of a second.
+	MakeTone(440.0f, 0.5f, 1.0f, samples);
+	TestTrue(TEXT("Extracts 440 Hz"), FNNPHapticEnvelope::Extract(samples.GetData(), samples.Num() / 2, 2, TEST_SAMPLE_RATE, TEST_FRAME_RATE, low));
+	TestEqual(TEXT("Frames"), low.NumFrames(), 60);
+	TestEqual(TEXT("Duration"), low.GetDuration(), 1.0f);
+
+	// Half scale is -9 dB RMS, 1 - 9/48 of the way up from the floor.  440 Hz is
+	// log(440 / 80) / log(4000 / 80) of the way from dull to bright, give or take
+	// the half crossing a 60th of a second window can miss.
+	for(i = 0; i < low.NumFrames(); i++)
+	{
+		TestEqual(FString::Printf(TEXT("Intensity at frame %d"), i), low.Intensity[i] / 255.0f, 1.0f - 9.03f / 48.0f, 0.01f);
+		TestEqual(FString::Printf(TEXT("Sharpness at frame %d"), i), low.Sharpness[i] / 255.0f, 0.436f, 0.03f);
+	}
+
+	// Quieter is weaker, and higher pitched is sharper.
+	MakeTone(440.0f, 0.05f, 1.0f, samples);
+	FNNPHapticEnvelope::Extract(samples.GetData(), samples.Num() / 2, 2, TEST_SAMPLE_RATE, TEST_FRAME_RATE, quiet);
+	MakeTone(2000.0f, 0.5f, 1.0f, samples);
+	FNNPHapticEnvelope::Extract(samples.GetData(), samples.Num() / 2, 2, TEST_SAMPLE_RATE, TEST_FRAME_RATE, high);
+
+	TestTrue(TEXT("Quieter tone is weaker"), quiet.NumFrames() > 0 && quiet.Intensity[0] < low.Intensity[0]);
+	TestTrue(TEXT("Higher tone is sharper"), high.NumFrames() > 0 && high.Sharpness[0] > low.Sharpness[0]);
+	TestEqual(TEXT("Loudness doesn't change sharpness"), (int32)quiet.Sharpness[0], (int32)low.Sharpness[0]);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNNPHapticEnvelopeSampleTest, "NNP.Haptics.Envelope.Sample", NNP_TEST_FLAGS)
+bool FNNPHapticEnvelopeSampleTest::RunTest(const FString& Parameters)
+{
+	FNNPHapticEnvelope envelope;
+	float intensity;
+	float sharpness;
+
+	envelope.FrameRate = 10.0f;
+	envelope.Intensity = { 0, 255, 51 };
+	envelope.Sharpness = { 255, 0, 0 };
+
+	TestEqual(TEXT("Duration"), envelope.GetDuration(), 0.3f);
+
+	// On a frame, its values.
+	envelope.Sample(0.1f, intensity, sharpness);
+	TestEqual(TEXT("Intensity on frame 1"), intensity, 1.0f, ENVELOPE_TOLERANCE);
+	TestEqual(TEXT("Sharpness on frame 1"), sharpness, 0.0f, ENVELOPE_TOLERANCE);
+
+	// Between frames, a straight line between them.
+	envelope.Sample(0.05f, intensity, sharpness);
+	TestEqual(TEXT("Intensity between frames 0 and 1"), intensity, 0.5f, ENVELOPE_TOLERANCE);
+	TestEqual(TEXT("Sharpness between frames 0 and 1"), sharpness, 0.5f, ENVELOPE_TOLERANCE);
+
+	envelope.Sample(0.175f, intensity, sharpness);
+	TestEqual(TEXT("Intensity three quarters from frame 1 to 2"), intensity, 0.4f, ENVELOPE_TOLERANCE);
+
+	// The last frame holds until the end, and after that there's nothing.
+	envelope.Sample(0.29f, intensity, sharpness);
+	TestEqual(TEXT("Intensity in the last frame"), intensity, 0.2f, ENVELOPE_TOLERANCE);
+
+	envelope.Sample(0.3f, intensity, sharpness);
+	TestEqual(TEXT("Intensity at the end"), intensity, 0.0f);
+	TestEqual(TEXT("Sharpness at the end"), sharpness, 0.0f);
+
+	envelope.Sample(5.0f, intensity, sharpness);
+	TestEqual(TEXT("Intensity long after the end"), intensity, 0.0f);
+
+	envelope.Sample(-0.1f, intensity, sharpness);
+	TestEqual(TEXT("Intensity before the start"), intensity, 0.0f);
+
+	// An empty envelope is silent everywhere.
+	envelope.Intensity.Reset();
+	envelope.Sharpness.Reset();
+	envelope.Sample(0.0f, intensity, sharpness);
+	TestEqual(TEXT("Intensity of an empty envelope"), intensity, 0.0f);
+	TestEqual(TEXT("Duration of an empty envelope"), envelope.GetDuration(), 0.0f);
+
+	return true;
+}
+
+#endif
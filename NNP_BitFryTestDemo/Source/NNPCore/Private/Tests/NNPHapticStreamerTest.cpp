@@ -0,0 +1,205 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NNPCoreTests.h"
+#include "NNPHapticStreamer.h"
+#include "NNPRecordingHapticsBackend.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// The streamer sends whole quantization steps.
+#define STREAMER_TOLERANCE (1.0f / 255.0f)
+
+// Full intensity at a fixed sharpness for the given number of 10 fps frames.
+static void MakeFlatEnvelope(int32 numFrames, uint8 sharpness, FNNPHapticEnvelope &envelope)
+{
+	int32 i;
+
+	envelope.FrameRate = 10.0f;
+	envelope.Intensity.Reset();
+	envelope.Sharpness.Reset();
+
+	for(i = 0; i < numFrames; i++)
+	{
+		envelope.Intensity.Add(255);
+		envelope.Sharpness.Add(sharpness);
+	}
+}
+
+// A streamer that has already told the backend it's idle, so tests only see what follows.
+static void StartIdle(FNNPHapticStreamer &streamer, FNNPRecordingHapticsBackend &backend)
+{
+	streamer.Update(0.0f, &backend);
+	backend.Updates.Reset();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNNPHapticStreamerBaseLevelTest, "NNP.Haptics.Streamer.BaseLevel", NNP_TEST_FLAGS)
+bool FNNPHapticStreamerBaseLevelTest::RunTest(const FString& Parameters)
+{
+	FNNPHapticStreamer streamer;
+	FNNPRecordingHapticsBackend backend;
+
+	// The very first update always reports, so the device starts from a known state.
+	streamer.Update(0.1f, &backend);
+	if(TestEqual(TEXT("First update"), backend.Updates.Num(), 1))
+	{
+		TestEqual(TEXT("First update intensity"), backend.Updates[0].Intensity, 0.0f);
+		TestEqual(TEXT("First update sharpness"), backend.Updates[0].Sharpness, streamer.IdleSharpness, STREAMER_TOLERANCE);
+	}
+	backend.Updates.Reset();
+
+	streamer.SetBaseLevel(0.25f, 0.75f);
+	streamer.Update(0.1f, &backend);
+	if(TestEqual(TEXT("Base level sent"), backend.Updates.Num(), 1))
+	{
+		TestEqual(TEXT("Base intensity"), backend.Updates[0].Intensity, 0.25f, STREAMER_TOLERANCE);
+		TestEqual(TEXT("Base sharpness"), backend.Updates[0].Sharpness, 0.75f, STREAMER_TOLERANCE);
+	}
+
+	// Only changes are pushed.
+	streamer.Update(0.1f, &backend);
+	streamer.SetBaseLevel(0.25f, 0.75f);
+	streamer.Update(0.1f, &backend);
+	TestEqual(TEXT("Unchanged level isn't sent again"), backend.Updates.Num(), 1);
+
+	// Less than half a quantization step doesn't count as a change.
+	streamer.SetBaseLevel(0.25f + 0.1f / 255.0f, 0.75f);
+	streamer.Update(0.1f, &backend);
+	TestEqual(TEXT("Change smaller than a step isn't sent"), backend.Updates.Num(), 1);
+
+	streamer.SetBaseLevel(0.25f, 0.9f);
+	streamer.Update(0.1f, &backend);
+	TestEqual(TEXT("Sharpness change is sent"), backend.Updates.Num(), 2);
+
+	// Back to nothing: zero intensity at the idle sharpness, whatever sharpness was asked for.
+	streamer.SetBaseLevel(0.0f, 0.3f);
+	streamer.Update(0.1f, &backend);
+	if(TestEqual(TEXT("Stop is sent"), backend.Updates.Num(), 3))
+	{
+		TestEqual(TEXT("Stop intensity"), backend.Updates[2].Intensity, 0.0f);
+		TestEqual(TEXT("Stop sharpness"), backend.Updates[2].Sharpness, streamer.IdleSharpness, STREAMER_TOLERANCE);
+	}
+
+	// Sharpness can't be felt at zero intensity, so changing it there sends nothing.
+	streamer.SetBaseLevel(0.0f, 0.9f);
+	streamer.Update(0.1f, &backend);
+	TestEqual(TEXT("Sharpness change at zero intensity isn't sent"), backend.Updates.Num(), 3);
+
+	// Out of range levels are clamped.
+	streamer.SetBaseLevel(2.0f, -1.0f);
+	streamer.Update(0.1f, &backend);
+	if(TestEqual(TEXT("Clamped level is sent"), backend.Updates.Num(), 4))
+	{
+		TestEqual(TEXT("Clamped intensity"), backend.Updates[3].Intensity, 1.0f);
+		TestEqual(TEXT("Clamped sharpness"), backend.Updates[3].Sharpness, 0.0f);
+	}
+
+	// No backend is fine; the update is just lost.
+	streamer.SetBaseLevel(0.5f, 0.5f);
+	streamer.Update(0.1f, nullptr);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNNPHapticStreamerPlaybackTest, "NNP.Haptics.Streamer.Playback", NNP_TEST_FLAGS)
+bool FNNPHapticStreamerPlaybackTest::RunTest(const FString& Parameters)
+{
+	FNNPHapticStreamer streamer;
+	FNNPRecordingHapticsBackend backend;
+	FNNPHapticEnvelope envelope;
+	int32 i;
+
+	MakeFlatEnvelope(3, 204, envelope);
+	StartIdle(streamer, backend);
+
+	// The envelope plays from its first frame, sends once while it holds steady,
+	// and sends zero once it has run out.
+	streamer.Play(&envelope, 0.5f);
+	TestTrue(TEXT("Playing"), streamer.IsPlaying());
+
+	for(i = 0; i < 5; i++)
+		streamer.Update(0.1f, &backend);
+
+	if(TestEqual(TEXT("Updates sent"), backend.Updates.Num(), 2))
+	{
+		TestEqual(TEXT("Intensity, scaled by gain"), backend.Updates[0].Intensity, 0.5f, STREAMER_TOLERANCE);
+		TestEqual(TEXT("Sharpness from the envelope"), backend.Updates[0].Sharpness, 0.8f, STREAMER_TOLERANCE);
+		TestEqual(TEXT("Intensity after the end"), backend.Updates[1].Intensity, 0.0f);
+	}
+	TestFalse(TEXT("Stopped"), streamer.IsPlaying());
+
+	// Over a base level, only an envelope stronger than the base is felt.
+	streamer.SetBaseLevel(0.3f, 0.1f);
+	streamer.Play(&envelope, 0.2f);
+	streamer.Update(0.1f, &backend);
+	if(TestEqual(TEXT("Updates with a weak envelope over the base"), backend.Updates.Num(), 3))
+		TestEqual(TEXT("Base wins over a weaker envelope"), backend.Updates[2].Intensity, 0.3f, STREAMER_TOLERANCE);
+
+	streamer.Play(&envelope, 1.0f);
+	streamer.Update(0.1f, &backend);
+	if(TestEqual(TEXT("Updates with a strong envelope over the base"), backend.Updates.Num(), 4))
+	{
+		TestEqual(TEXT("Stronger envelope wins over the base"), backend.Updates[3].Intensity, 1.0f);
+		TestEqual(TEXT("Stronger envelope brings its sharpness"), backend.Updates[3].Sharpness, 0.8f, STREAMER_TOLERANCE);
+	}
+
+	// StopAll drops to the base level on the next update.
+	streamer.StopAll();
+	streamer.Update(0.1f, &backend);
+	if(TestEqual(TEXT("Updates after StopAll"), backend.Updates.Num(), 5))
+		TestEqual(TEXT("Back to the base level"), backend.Updates[4].Intensity, 0.3f, STREAMER_TOLERANCE);
+
+	// Nothing to play is ignored.
+	streamer.Play(nullptr);
+	streamer.Play(&envelope, 0.0f);
+	TestFalse(TEXT("Nothing started"), streamer.IsPlaying());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNNPHapticStreamerVoiceStealingTest, "NNP.Haptics.Streamer.VoiceStealing", NNP_TEST_FLAGS)
+bool FNNPHapticStreamerVoiceStealingTest::RunTest(const FString& Parameters)
+{
+	static const float gains[MAX_HAPTIC_VOICES] = { 1.0f, 0.4f, 0.3f, 0.2f };
+	FNNPHapticStreamer streamer;
+	FNNPRecordingHapticsBackend backend;
+	FNNPHapticEnvelope envelope;
+	int32 i;
+
+	MakeFlatEnvelope(20, 128, envelope);
+	StartIdle(streamer, backend);
+
+	// Fill every voice, oldest and strongest first.
+	for(i = 0; i < MAX_HAPTIC_VOICES; i++)
+	{
+		streamer.Play(&envelope, gains[i]);
+		streamer.Update(0.1f, &backend);
+	}
+
+	if(TestEqual(TEXT("Updates while filling the voices"), backend.Updates.Num(), 1))
+		TestEqual(TEXT("Strongest voice wins"), backend.Updates[0].Intensity, 1.0f);
+
+	// One more takes the oldest voice, which was the strongest.
+	streamer.Play(&envelope, 0.5f);
+	streamer.Update(0.1f, &backend);
+	if(TestEqual(TEXT("Updates after stealing"), backend.Updates.Num(), 2))
+		TestEqual(TEXT("Oldest voice was replaced"), backend.Updates[1].Intensity, 0.5f, STREAMER_TOLERANCE);
+
+	// The next steal takes the 0.4 voice, which leaves the new 0.5 one strongest still.
+	streamer.Play(&envelope, 0.1f);
+	streamer.Update(0.1f, &backend);
+	TestEqual(TEXT("Updates after stealing again"), backend.Updates.Num(), 2);
+
+	// As the voices run out the next strongest takes over, and once they all
+	// have, zero is sent exactly once.
+	for(i = 0; i < 30; i++)
+		streamer.Update(0.1f, &backend);
+
+	TestFalse(TEXT("Nothing playing"), streamer.IsPlaying());
+	TestEqual(TEXT("Stopped"), backend.Updates.Last().Intensity, 0.0f);
+	for(i = 0; i < backend.Updates.Num() - 1; i++)
+		TestTrue(FString::Printf(TEXT("Update %d before the end is not zero"), i), backend.Updates[i].Intensity > 0.0f);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,182 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NNPCoreTests.h"
+#include "NNPScalabilityGovernor.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Share of the frame each quality level saves in the replay model below.
+#define LEVEL_SAVING 0.15f
+
+// What a replay produced: the level after each change, and the frame it changed on.
+struct FGovernorReplay
+{
+	TArray<int32> Levels;
+	TArray<int32> Frames;
+};
+
+// Replays a trace of full-quality frame costs.  Unlike a recorded trace, the
+// frame time fed back responds to the level the governor picks, so a downshift
+// actually buys headroom the way it would in game.
+static void ReplayTrace(FNNPScalabilityGovernor &governor, int32 numFrames, TFunctionRef<float(int32)> costMs, float gameThreadRatio, FGovernorReplay &replay)
+{
+	int32 frame;
+
+	for(frame = 0; frame < numFrames; frame++)
+	{
+		float frameMs = costMs(frame) * (1.0f - LEVEL_SAVING * governor.GetLevel());
+
+		if(governor.Sample(frameMs, frameMs * gameThreadRatio))
+		{
+			replay.Levels.Add(governor.GetLevel());
+			replay.Frames.Add(frame);
+		}
+	}
+}
+
+// Comfortably inside the band between upshift and downshift: nothing should change.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNNPGovernorSteadyTest, "NNP.Governor.Steady", NNP_TEST_FLAGS)
+bool FNNPGovernorSteadyTest::RunTest(const FString& Parameters)
+{
+	FNNPScalabilityGovernor governor;
+	FGovernorReplay replay;
+
+	// 16 ms frames with 12 ms on the game thread: under budget, but not by enough to step up.
+	ReplayTrace(governor, 3000, [](int32 frame) { return 16.0f; }, 0.75f, replay);
+
+	TestEqual(TEXT("Level changes"), replay.Levels.Num(), 0);
+	TestEqual(TEXT("Final level"), governor.GetLevel(), 0);
+
+	// A single hitch is smoothed away rather than acted on.
+	ReplayTrace(governor, 3000, [](int32 frame) { return frame == 1000 ? 200.0f : 16.0f; }, 0.75f, replay);
+
+	TestEqual(TEXT("Level changes with a hitch"), replay.Levels.Num(), 0);
+
+	return true;
+}
+
+// The device throttles for a while and then recovers.  The governor should step
+// down until the frame fits, hold there, and step back up once it cools.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNNPGovernorThrottlingTest, "NNP.Governor.Throttling", NNP_TEST_FLAGS)
+bool FNNPGovernorThrottlingTest::RunTest(const FString& Parameters)
+{
+	FNNPScalabilityGovernor governor;
+	FGovernorReplay replay;
+	TArray<int32> expectedLevels = { 1, 2, 1, 0 };
+	const FNNPGovernorSettings& settings = governor.GetSettings();
+
+	// 15 ms normally, 22 ms while throttled from frame 300 to 3000.  Level 1 still
+	// misses the 60 Hz budget when throttled; level 2 makes it.
+	ReplayTrace(governor, 6000, [](int32 frame) { return frame >= 300 && frame < 3000 ? 22.0f : 15.0f; }, 0.8f, replay);
+
+	TestTrue(TEXT("Level sequence is 1, 2, 1, 0"), replay.Levels == expectedLevels);
+	if(replay.Frames.Num() != expectedLevels.Num())
+		return false;
+
+	// Stepping down waits for DownshiftFrames over budget; the second step also waits for the first to settle.
+	TestTrue(TEXT("First downshift is quick"), replay.Frames[0] - 300 >= settings.DownshiftFrames && replay.Frames[0] - 300 < settings.DownshiftFrames + 10);
+	TestTrue(TEXT("Second downshift follows the settle"), replay.Frames[1] - replay.Frames[0] >= settings.SettleFrames + settings.DownshiftFrames);
+	TestTrue(TEXT("Level 2 holds while throttled"), replay.Frames[2] > 3000);
+
+	// Stepping up waits for UpshiftFrames of headroom after every change.
+	TestTrue(TEXT("First upshift is slow"), replay.Frames[2] - 3000 >= settings.UpshiftFrames);
+	TestTrue(TEXT("Second upshift follows the settle"), replay.Frames[3] - replay.Frames[2] >= settings.SettleFrames + settings.UpshiftFrames);
+
+	// Both upshifts held, so neither level was penalized.
+	TestEqual(TEXT("Level 0 backoff"), governor.GetUpshiftBackoff(0), 1);
+	TestEqual(TEXT("Level 1 backoff"), governor.GetUpshiftBackoff(1), 1);
+
+	return true;
+}
+
+// Full quality is just over budget and level 1 has plenty of headroom, so the
+// governor keeps trying level 0 and failing.  It must keep trying less often.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNNPGovernorOscillatingTest, "NNP.Governor.Oscillating", NNP_TEST_FLAGS)
+bool FNNPGovernorOscillatingTest::RunTest(const FString& Parameters)
+{
+	FNNPScalabilityGovernor governor;
+	FGovernorReplay replay;
+	const FNNPGovernorSettings& settings = governor.GetSettings();
+	int32 lastWait = 0;
+	int32 i;
+
+	// 20 ms at level 0, 17 ms at level 1 with only 10 ms of that on the game thread.
+	ReplayTrace(governor, 40000, [](int32 frame) { return 20.0f; }, 0.6f, replay);
+
+	TestTrue(TEXT("Oscillates"), replay.Levels.Num() >= 12);
+
+	for(i = 0; i < replay.Levels.Num(); i++)
+		TestEqual(FString::Printf(TEXT("Level after change %d"), i), replay.Levels[i], i % 2 == 0 ? 1 : 0);
+
+	// Changes alternate down, up, down, up...  Every upshift after the first follows
+	// a failed one, so the wait at level 1 before it grows until the backoff is capped.
+	for(i = 1; i < replay.Frames.Num(); i += 2)
+	{
+		int32 wait = replay.Frames[i] - replay.Frames[i - 1];
+		int32 backoff = FMath::Min(1 << (i / 2), MAX_UPSHIFT_BACKOFF);
+		int32 minWait = settings.SettleFrames + settings.UpshiftFrames * backoff;
+
+		TestTrue(FString::Printf(TEXT("Upshift %d waits out a backoff of %d"), i / 2, backoff), wait >= minWait && wait < minWait + 30);
+		TestTrue(FString::Printf(TEXT("Upshift %d waits no less than the last"), i / 2), wait >= lastWait);
+		lastWait = wait;
+	}
+
+	TestEqual(TEXT("Level 0 backoff is capped"), governor.GetUpshiftBackoff(0), MAX_UPSHIFT_BACKOFF);
+
+	return true;
+}
+
+// Feed frames until the level changes.  Returns the new level, or -1 if it never did.
+static int32 SampleUntilChange(FNNPScalabilityGovernor &governor, float frameMs, float gameThreadMs)
+{
+	int32 frame;
+
+	for(frame = 0; frame < 100000; frame++)
+	{
+		if(governor.Sample(frameMs, gameThreadMs))
+			return governor.GetLevel();
+	}
+
+	return -1;
+}
+
+// Drive the governor through failed upshifts one at a time and watch the backoff.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNNPGovernorBackoffTest, "NNP.Governor.UpshiftBackoff", NNP_TEST_FLAGS)
+bool FNNPGovernorBackoffTest::RunTest(const FString& Parameters)
+{
+	FNNPScalabilityGovernor governor;
+	int32 expected = 1;
+	int32 failures;
+
+	TestEqual(TEXT("Initial backoff"), governor.GetUpshiftBackoff(0), 1);
+	TestEqual(TEXT("First downshift"), SampleUntilChange(governor, 20.0f, 12.0f), 1);
+	TestEqual(TEXT("Downshift from full quality costs nothing"), governor.GetUpshiftBackoff(0), 1);
+
+	for(failures = 1; failures <= 8; failures++)
+	{
+		TestEqual(FString::Printf(TEXT("Upshift %d"), failures), SampleUntilChange(governor, 10.0f, 6.0f), 0);
+		TestEqual(FString::Printf(TEXT("Failed upshift %d"), failures), SampleUntilChange(governor, 20.0f, 12.0f), 1);
+
+		expected = FMath::Min(expected * 2, MAX_UPSHIFT_BACKOFF);
+		TestEqual(FString::Printf(TEXT("Backoff after %d failed upshifts"), failures), governor.GetUpshiftBackoff(0), expected);
+		TestEqual(FString::Printf(TEXT("Level 1 untouched after %d failed upshifts"), failures), governor.GetUpshiftBackoff(1), 1);
+	}
+
+	governor.Reset();
+	TestEqual(TEXT("Backoff after reset"), governor.GetUpshiftBackoff(0), 1);
+
+	// One failure, then an upshift that holds: a downshift long after it isn't a failure.
+	SampleUntilChange(governor, 20.0f, 12.0f);
+	SampleUntilChange(governor, 10.0f, 6.0f);
+	SampleUntilChange(governor, 20.0f, 12.0f);
+	TestEqual(TEXT("Backoff after one failed upshift"), governor.GetUpshiftBackoff(0), 2);
+
+	TestEqual(TEXT("Held upshift"), SampleUntilChange(governor, 10.0f, 6.0f), 0);
+	TestEqual(TEXT("Level 0 holds"), SampleUntilChange(governor, 16.0f, 12.0f), -1);
+	TestEqual(TEXT("Late downshift"), SampleUntilChange(governor, 20.0f, 12.0f), 1);
+	TestEqual(TEXT("Backoff after a late downshift"), governor.GetUpshiftBackoff(0), 2);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,43 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Splits variable frame times into fixed-length simulation steps.
+ *
+ * Every step is StepSeconds long and sees whatever input the caller latched for
+ * the frame, so a given input trace produces the same steps at any frame rate
+ * whose frames never owe more than MaxSubSteps steps.
+ *
+ * After a hitch, MaxSubSteps steps run as usual and whatever whole steps are
+ * still owed run as one longer catch-up step, so no simulated time is lost but
+ * the frame doesn't pay for every step either.  The catch-up step integrates
+ * differently from the short steps it replaces, so from a hitch on the results
+ * are no longer the same as at other frame rates.
+ */
+class NNPCORE_API FNNPFixedStepper
+{
+public:
+	FNNPFixedStepper(float stepRate = 60.0f, int32 maxSubSteps = 4);
+
+	void SetRate(float stepRate, int32 maxSubSteps);
+	void Reset();
+
+	// Add a frame's time and run the steps it completes.  Returns how many steps
+	// were run, counting a catch-up step as one.
+	int32 Advance(float deltaSeconds, TFunctionRef<void(float stepSeconds)> step);
+
+	// How far the frame has got into the next step, from 0 to 1.  Use it to draw
+	// between the state before and after the last step.
+	float GetAlpha() const;
+
+	float GetStepSeconds() const;
+
+protected:
+	double StepSeconds;
+	int32 MaxSubSteps;
+	// Simulated time owed, always less than one step between frames.
+	double Accumulator;
+};
@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#define MAX_GESTURE_TOUCHES 2
+#define MAX_GESTURE_EVENTS 16
+
+typedef enum NNP_GESTURES
+{
+	Tap_Gesture = 0,
+	DoubleTap_Gesture,
+	Swipe_Gesture,
+	Hold_Gesture,
+	Pinch_Gesture,
+
+	MAX_GESTURES
+} NNPGestures;
+
+struct GestureEvent
+{
+	NNPGestures Type;
+	// Where the gesture happened, in screen space.  The midpoint for a pinch.
+	FVector2D Position;
+	// Unit direction of a swipe, in screen space (+Y is down).
+	FVector2D Direction;
+	// Finger spread relative to the previous pinch event.  >1 spreads, <1 pinches.
+	float PinchScale;
+	// Time of the touch sample that completed the gesture.
+	double SampleTime;
+};
+
+// Recognition latency per gesture type: from the completing touch sample to the
+// gesture being handed to the character.
+struct GestureLatency
+{
+	int32 Count;
+	double TotalSeconds;
+	double MaxSeconds;
+};
+
+/**
+ * Turns a stream of touch samples into gestures.
+ *
+ * Every sample is handled in constant time against a fixed amount of per-finger
+ * state, and recognized gestures wait in a fixed-size queue until the character
+ * drains it.  All times are passed in by the caller, so a recorded touch trace
+ * replays to exactly the same gestures.
+ *
+ * Taps are reported as soon as the finger lifts, so nothing waits on a double
+ * tap.  A second tap within DoubleTapInterval is reported as a tap and then a
+ * double tap, so bind the two to actions that make sense together.
+ */
+class NNPCORE_API FNNPGestureRecognizer
+{
+public:
+	FNNPGestureRecognizer();
+
+	void Reset();
+
+	// Feed one touch sample.  Pressed is true while the finger is down.
+	void AddSample(int32 finger, bool pressed, FVector2D position, double time);
+
+	// Advance time with no new samples, so holds are recognized while a finger rests.
+	void Update(double time);
+
+	// Take the oldest gesture off the queue.  Returns false if it is empty.
+	bool PopEvent(GestureEvent &event, double time);
+
+	const GestureLatency& GetLatency(NNPGestures gesture) const;
+
+	// Tuning, in seconds and screen pixels.
+	float TapMaxDuration;
+	float TapSlop;
+	float DoubleTapInterval;
+	float DoubleTapSlop;
+	float SwipeMinDistance;
+	float SwipeMaxDuration;
+	float HoldDuration;
+	float PinchMinChange;
+
+protected:
+	struct TouchState
+	{
+		bool Down;
+		// Moved further than TapSlop since going down.
+		bool Moved;
+		// Already used by a hold or pinch, so releasing it is not a tap or swipe.
+		bool Consumed;
+		FVector2D StartPos;
+		FVector2D Pos;
+		double StartTime;
+	};
+
+	TouchState Touches[MAX_GESTURE_TOUCHES];
+
+	// The last tap, which a second one can pair with to make a double tap.
+	bool HasLastTap;
+	FVector2D LastTapPos;
+	double LastTapTime;
+
+	bool Pinching;
+	float PinchDistance;
+
+	GestureEvent Events[MAX_GESTURE_EVENTS];
+	int32 EventHead;
+	int32 EventCount;
+
+	GestureLatency Latency[MAX_GESTURES];
+
+	GestureEvent& PushEvent(NNPGestures type, FVector2D position, double time);
+	void TouchReleased(TouchState &touch, double time);
+	void UpdatePinch(double time);
+};
@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#define HAPTIC_ENVELOPE_DEFAULT_RATE 60.0f
+
+/**
+ * Haptic intensity and sharpness over time for one sound, baked offline.
+ *
+ * Both curves hold one byte per frame at FrameRate, 0-255 for 0-1.  A couple of
+ * seconds of audio comes out at a few hundred bytes, and playing it back is just
+ * indexing the arrays.
+ */
+struct NNPCORE_API FNNPHapticEnvelope
+{
+	FNNPHapticEnvelope();
+
+	float FrameRate;
+	TArray<uint8> Intensity;
+	TArray<uint8> Sharpness;
+
+	int32 NumFrames() const;
+	float GetDuration() const;
+
+	// Values at the given time, interpolated between frames.  Zero intensity past the end.
+	void Sample(float time, float &intensity, float &sharpness) const;
+
+	// Build an envelope from interleaved 16 bit PCM.  Intensity follows loudness
+	// on a decibel scale with a short release; sharpness follows the zero
+	// crossing rate, a cheap stand-in for how bright the sound is.
+	// Returns false if there is nothing to analyze.
+	static bool Extract(const int16 *samples, int32 numFrames, int32 numChannels, int32 sampleRate, float frameRate, FNNPHapticEnvelope &envelope);
+
+	friend NNPCORE_API FArchive& operator<<(FArchive &Ar, FNNPHapticEnvelope &envelope);
+};
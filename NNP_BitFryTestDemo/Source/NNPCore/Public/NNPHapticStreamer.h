@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NNPHapticEnvelope.h"
+
+#define MAX_HAPTIC_VOICES 4
+
+// Whatever actually drives the haptics.  ANNPPlayerController on device; anything
+// that records the calls elsewhere.
+class INNPHapticsBackend
+{
+public:
+	virtual ~INNPHapticsBackend() {}
+
+	virtual void UpdateHaptics(float intensity, float sharpness) = 0;
+};
+
+/**
+ * Plays baked haptic envelopes alongside their sounds.
+ *
+ * Up to MAX_HAPTIC_VOICES envelopes play at once over a caller-set base level,
+ * and whichever is strongest wins each frame.  The backend only hears about a
+ * change once the output moves by a quantization step, and hears zero intensity
+ * once everything has stopped.  The caller owns the envelopes and must keep them
+ * alive while they play.
+ */
+class NNPCORE_API FNNPHapticStreamer
+{
+public:
+	FNNPHapticStreamer();
+
+	// Start an envelope, scaled by gain.  Takes the oldest voice if all are busy.
+	void Play(const FNNPHapticEnvelope *envelope, float gain = 1.0f);
+
+	void StopAll();
+
+	bool IsPlaying() const;
+
+	// Continuous level under the envelopes, e.g. from the surface being walked on.
+	void SetBaseLevel(float intensity, float sharpness);
+
+	// Advance every voice and push the result to the backend if it changed.
+	void Update(float deltaSeconds, INNPHapticsBackend *backend);
+
+	// Sharpness sent along with zero intensity.
+	float IdleSharpness;
+
+protected:
+	struct HapticVoice
+	{
+		const FNNPHapticEnvelope *Envelope;
+		float Time;
+		float Gain;
+	};
+
+	HapticVoice Voices[MAX_HAPTIC_VOICES];
+
+	float BaseIntensity;
+	float BaseSharpness;
+
+	// Last values sent, in quantization steps.  -1 until the first update.
+	int32 LastIntensity;
+	int32 LastSharpness;
+};
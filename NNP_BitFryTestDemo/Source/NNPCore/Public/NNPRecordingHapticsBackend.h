@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NNPHapticStreamer.h"
+
+struct HapticsUpdate
+{
+	float Intensity;
+	float Sharpness;
+};
+
+// Keeps every update instead of driving a device, for tests and headless runs.
+class FNNPRecordingHapticsBackend : public INNPHapticsBackend
+{
+public:
+	TArray<HapticsUpdate> Updates;
+
+	virtual void UpdateHaptics(float intensity, float sharpness) override
+	{
+		Updates.Add({ intensity, sharpness });
+	}
+};
@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Longest an upshift is held off for, in multiples of UpshiftFrames.
+#define MAX_UPSHIFT_BACKOFF 16
+
+// Tuning for FNNPScalabilityGovernor.  Times are in milliseconds, windows in frames.
+struct FNNPGovernorSettings
+{
+	float TargetFrameTimeMs = 1000.0f / 60.0f;
+
+	// Step quality down once smoothed frame time exceeds target * DownshiftRatio...
+	float DownshiftRatio = 1.1f;
+	int32 DownshiftFrames = 30;
+
+	// ...and back up once smoothed game-thread time has stayed under target * UpshiftRatio.
+	// With the frame rate locked, game-thread time is the only signal of headroom.
+	float UpshiftRatio = 0.7f;
+	int32 UpshiftFrames = 300;
+
+	// Frames to ignore after a level change while the new settings take effect.
+	int32 SettleFrames = 60;
+
+	// Weight of the newest sample in the moving averages.
+	float SmoothingFactor = 0.1f;
+
+	// Number of quality levels below full quality.
+	int32 MaxLevel = 3;
+};
+
+/**
+ * Decides which scalability level to run at from per-frame timings.
+ * Level 0 is full quality; each level above it trades quality for time.
+ *
+ * The decision logic is plain arithmetic on the samples it is given, so a
+ * recorded frame-time trace always replays to the same sequence of levels.
+ * Stepping down is quick and stepping up is slow.  If stepping up to a level
+ * immediately has to be undone, the wait before trying that level again doubles.
+ */
+class NNPCORE_API FNNPScalabilityGovernor
+{
+public:
+	FNNPScalabilityGovernor(const FNNPGovernorSettings& settings = FNNPGovernorSettings());
+
+	void Reset();
+
+	// Feed one frame.  Returns true if the level changed.
+	bool Sample(float frameTimeMs, float gameThreadTimeMs);
+
+	int32 GetLevel() const;
+	float GetSmoothedFrameTimeMs() const;
+	float GetSmoothedGameThreadTimeMs() const;
+	// Multiplier on UpshiftFrames before stepping up to the given level again.
+	int32 GetUpshiftBackoff(int32 level) const;
+	const FNNPGovernorSettings& GetSettings() const;
+
+protected:
+	FNNPGovernorSettings Settings;
+
+	int32 Level;
+	float SmoothedFrameMs;
+	float SmoothedGameThreadMs;
+	bool bHasSamples;
+
+	int32 OverBudgetFrames;
+	int32 UnderBudgetFrames;
+	int32 SettleFramesLeft;
+
+	// Frame count since the last upshift, used to spot an upshift that didn't hold.
+	int32 FramesSinceUpshift;
+	// Extra multiplier on UpshiftFrames for each level, doubled on every failed upshift.
+	int32 UpshiftBackoff[8];
+};
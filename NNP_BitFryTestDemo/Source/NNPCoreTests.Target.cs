@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+// Console program that runs the NNPCore automation tests without the engine.
+public class NNPCoreTestsTarget : TargetRules
+{
+	public NNPCoreTestsTarget(TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Program;
+		DefaultBuildSettings = BuildSettingsVersion.V2;
+		LinkType = TargetLinkType.Monolithic;
+		LaunchModuleName = "NNPCoreTests";
+
+		bBuildDeveloperTools = false;
+		bCompileAgainstEngine = false;
+		bCompileAgainstCoreUObject = false;
+		bCompileAgainstApplicationCore = false;
+		bIsBuildingConsoleApplication = true;
+		bForceCompileDevelopmentAutomationTests = true;
+	}
+}
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "RequiredProgramMainCPPInclude.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogNNPCoreTests, Log, All);
+
+IMPLEMENT_APPLICATION(NNPCoreTests, "NNPCoreTests");
+
+// Runs every NNP automation test linked in from NNPCore, or only those whose
+// name starts with -filter=<prefix>.  Exits non-zero if any fail.
+INT32_MAIN_INT32_ARGC_TCHAR_ARGV()
+{
+	FAutomationTestFramework &framework = FAutomationTestFramework::Get();
+	TArray<FAutomationTestInfo> tests;
+	FString filter = TEXT("NNP.");
+	int32 numRun = 0;
+	int32 numFailed = 0;
+
+	GEngineLoop.PreInit(ArgC, ArgV);
+
+	FParse::Value(FCommandLine::Get(), TEXT("filter="), filter);
+
+	framework.SetRequestedTestFilter(EAutomationTestFlags::ProductFilter);
+	framework.GetValidTestNames(tests);
+
+	for(const FAutomationTestInfo& test : tests)
+	{
+		FAutomationTestExecutionInfo result;
+
+		if(!test.GetFullTestPath().StartsWith(filter))
+			continue;
+
+		framework.StartTestByName(test.GetTestName(), 0);
+		if(!framework.StopTest(result))
+		{
+			for(const FAutomationExecutionEntry& entry : result.GetEntries())
+			{
+				if(entry.Event.Type == EAutomationEventType::Error)
+					UE_LOG(LogNNPCoreTests, Error, TEXT("%s: %s"), *test.GetFullTestPath(), *entry.Event.Message);
+			}
+
+			UE_LOG(LogNNPCoreTests, Error, TEXT("FAIL %s"), *test.GetFullTestPath());
+			numFailed++;
+		}
+		else
+			UE_LOG(LogNNPCoreTests, Display, TEXT("PASS %s"), *test.GetFullTestPath());
+
+		numRun++;
+	}
+
+	UE_LOG(LogNNPCoreTests, Display, TEXT("%d tests, %d failed"), numRun, numFailed);
+
+	FEngineLoop::AppPreExit();
+	FEngineLoop::AppExit();
+
+	return (numRun == 0 || numFailed) ? 1 : 0;
+}
@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NNPAnimInstance.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("NNP Anim Gather"), STAT_NNPAnimGather, STATGROUP_Anim);
+DECLARE_CYCLE_STAT(TEXT("NNP Anim Update"), STAT_NNPAnimUpdate, STATGROUP_Anim);
+DECLARE_CYCLE_STAT(TEXT("NNP Anim Evaluate"), STAT_NNPAnimEvaluate, STATGROUP_Anim);
+
+FThreadSafeCounter64 UNNPAnimInstance::GatherCycles;
+FThreadSafeCounter64 UNNPAnimInstance::WorkerCycles;
+
+void FNNPAnimInstanceProxy::PreUpdate(UAnimInstance *InAnimInstance, float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_NNPAnimGather);
+	uint32 startCycles = FPlatformTime::Cycles();
+
+	Super::PreUpdate(InAnimInstance, DeltaSeconds);
+
+	// Only plain copies here; this is the part that stays on the game thread.
+	ACharacter *character = Cast<ACharacter>(InAnimInstance->TryGetPawnOwner());
+	if(character)
+	{
+		Velocity = character->GetVelocity();
+		bIsFalling = character->GetCharacterMovement()->IsFalling();
+	}
+	else
+	{
+		Velocity = FVector::ZeroVector;
+		bIsFalling = false;
+	}
+
+	UNNPAnimInstance::GatherCycles.Add(FPlatformTime::Cycles() - startCycles);
+}
+
+void FNNPAnimInstanceProxy::Update(float DeltaSeconds)
+{
+	Super::Update(DeltaSeconds);
+
+	Speed = Velocity.Size2D();
+	bIsInAir = bIsFalling;
+}
+
+void FNNPAnimInstanceProxy::UpdateAnimationNode(const FAnimationUpdateContext& InContext)
+{
+	SCOPE_CYCLE_COUNTER(STAT_NNPAnimUpdate);
+	uint32 startCycles = FPlatformTime::Cycles();
+
+	Super::UpdateAnimationNode(InContext);
+
+	UNNPAnimInstance::WorkerCycles.Add(FPlatformTime::Cycles() - startCycles);
+}
+
+bool FNNPAnimInstanceProxy::Evaluate(FPoseContext& Output)
+{
+	SCOPE_CYCLE_COUNTER(STAT_NNPAnimEvaluate);
+	uint32 startCycles = FPlatformTime::Cycles();
+
+	bool result = Super::Evaluate(Output);
+
+	UNNPAnimInstance::WorkerCycles.Add(FPlatformTime::Cycles() - startCycles);
+	return result;
+}
+
+float UNNPAnimInstance::GetSpeed() const
+{
+	return GetProxyOnAnyThread<FNNPAnimInstanceProxy>().Speed;
+}
+
+bool UNNPAnimInstance::IsInAir() const
+{
+	return GetProxyOnAnyThread<FNNPAnimInstanceProxy>().bIsInAir;
+}
+
+void UNNPAnimInstance::ConsumeCycles(int64 &gatherCycles, int64 &workerCycles)
+{
+	gatherCycles = GatherCycles.Set(0);
+	workerCycles = WorkerCycles.Set(0);
+}
+
+FAnimInstanceProxy* UNNPAnimInstance::CreateAnimInstanceProxy()
+{
+	return &Proxy;
+}
+
+void UNNPAnimInstance::DestroyAnimInstanceProxy(FAnimInstanceProxy *InProxy)
+{
+	// The proxy is a member; nothing to free.
+}
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "HAL/ThreadSafeCounter64.h"
+#include "NNPAnimInstance.generated.h"
+
+/**
+ * Animation state for the mannequin.  PreUpdate copies what it needs from the
+ * character on the game thread; everything else, including the anim graph,
+ * runs on a worker thread.
+ */
+USTRUCT(BlueprintType)
+struct FNNPAnimInstanceProxy : public FAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+	FNNPAnimInstanceProxy() : FAnimInstanceProxy(), Velocity(FVector::ZeroVector), bIsFalling(false), Speed(0.0f), bIsInAir(false)
+	{
+	}
+
+	FNNPAnimInstanceProxy(UAnimInstance *Instance) : FAnimInstanceProxy(Instance), Velocity(FVector::ZeroVector), bIsFalling(false), Speed(0.0f), bIsInAir(false)
+	{
+	}
+
+protected:
+	// FAnimInstanceProxy interface
+	virtual void PreUpdate(UAnimInstance *InAnimInstance, float DeltaSeconds) override;
+	virtual void Update(float DeltaSeconds) override;
+	virtual void UpdateAnimationNode(const FAnimationUpdateContext& InContext) override;
+	virtual bool Evaluate(FPoseContext& Output) override;
+	// End of FAnimInstanceProxy interface
+
+	// Copied from the character on the game thread.
+	FVector Velocity;
+	bool bIsFalling;
+
+public:
+	/** Ground speed, for the IdleRun blendspace. */
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Animation)
+	float Speed;
+
+	/** True while jumping or falling. */
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Animation)
+	bool bIsInAir;
+};
+
+/**
+ * Native parent for ThirdPerson_AnimBP.  Replaces the blueprint event graph that
+ * gathered speed and in-air state each frame, so the whole update can run off the
+ * game thread.  Read the values through the getters or the Proxy member.
+ */
+UCLASS(Transient, Blueprintable)
+class NNP_BITFRYTESTDEMO_API UNNPAnimInstance : public UAnimInstance
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintPure, Category = Animation, meta = (BlueprintThreadSafe))
+	float GetSpeed() const;
+
+	UFUNCTION(BlueprintPure, Category = Animation, meta = (BlueprintThreadSafe))
+	bool IsInAir() const;
+
+	// Cycles spent in mannequin animation since the last call: gathering on the
+	// game thread, and graph update plus evaluation on any thread.
+	static void ConsumeCycles(int64 &gatherCycles, int64 &workerCycles);
+
+protected:
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Animation, meta = (AllowPrivateAccess = "true"))
+	FNNPAnimInstanceProxy Proxy;
+
+	// UAnimInstance interface
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override;
+	virtual void DestroyAnimInstanceProxy(FAnimInstanceProxy *InProxy) override;
+	// End of UAnimInstance interface
+
+	friend struct FNNPAnimInstanceProxy;
+
+	static FThreadSafeCounter64 GatherCycles;
+	static FThreadSafeCounter64 WorkerCycles;
+};
@@ -0,0 +1,373 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NNPContentFootprintCommandlet.h"
+#include "NNP_BitFryTestDemo.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if WITH_EDITOR
+#include "AssetRegistryModule.h"
+#include "GameMapsSettings.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/HUD.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
+#include "Settings/ProjectPackagingSettings.h"
+#include "UObject/UObjectIterator.h"
+#endif
+
+#define REPORT_MAX_ROWS 30
+#define GC_INTERVAL_PACKAGES 50
+#define BYTES_TO_MB(bytes) ((bytes) / (1024.0 * 1024.0))
+
+UNNPContentFootprintCommandlet::UNNPContentFootprintCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+#if WITH_EDITOR
+
+struct FNNPPackageFootprint
+{
+	FName PackageName;
+	FString Folder;
+	int64 DiskBytes;
+	int64 MemoryBytes;
+	bool Referenced;
+};
+
+struct FNNPFolderFootprint
+{
+	int32 NumPackages;
+	int32 NumReferenced;
+	int64 ReferencedBytes;
+	int64 UnreferencedBytes;
+	int64 MemoryBytes;
+};
+
+static void AddClassRoot(TSet<FName>& roots, UClass *classObject)
+{
+	if(classObject && !classObject->GetOutermost()->GetName().StartsWith(TEXT("/Script/")))
+		roots.Add(classObject->GetOutermost()->GetFName());
+}
+
+// The maps the game boots into, plus the blueprint classes the game mode
+// pulls in from C++, which the asset registry can't see.
+static void GatherDefaultRoots(TSet<FName>& roots)
+{
+	FString gameDefaultMap = UGameMapsSettings::GetGameDefaultMap();
+	FString gameModePath = UGameMapsSettings::GetGlobalDefaultGameMode();
+	const UGameMapsSettings *mapsSettings = GetDefault<UGameMapsSettings>();
+
+	if(!gameDefaultMap.IsEmpty())
+		roots.Add(FName(*FPackageName::ObjectPathToPackageName(gameDefaultMap)));
+
+	if(mapsSettings->TransitionMap.IsValid())
+		roots.Add(FName(*mapsSettings->TransitionMap.GetLongPackageName()));
+
+	UClass *gameModeClass = LoadClass<AGameModeBase>(nullptr, *gameModePath);
+	if(gameModeClass)
+	{
+		const AGameModeBase *gameMode = gameModeClass->GetDefaultObject<AGameModeBase>();
+
+		AddClassRoot(roots, gameModeClass);
+		AddClassRoot(roots, gameMode->DefaultPawnClass);
+		AddClassRoot(roots, gameMode->HUDClass);
+		AddClassRoot(roots, gameMode->PlayerControllerClass);
+	}
+	else
+		UE_LOG(LogNNP, Warning, TEXT("Could not load the default game mode %s"), *gameModePath);
+}
+
+// Adds a package to the roots if it is project content.
+static void AddPackageRoot(TSet<FName>& roots, const FString& packageName)
+{
+	if(packageName.StartsWith(TEXT("/Game/")))
+		roots.Add(FName(*packageName));
+}
+
+// What the cooker takes regardless of references: the packaging settings'
+// MapsToCook and everything under DirectoriesToAlwaysCook.
+static void GatherCookSettingsRoots(TSet<FName>& roots, IAssetRegistry& assetRegistry)
+{
+	const UProjectPackagingSettings *packagingSettings = GetDefault<UProjectPackagingSettings>();
+
+	for(const FFilePath& map : packagingSettings->MapsToCook)
+		AddPackageRoot(roots, FPackageName::ObjectPathToPackageName(map.FilePath));
+
+	for(const FDirectoryPath& directory : packagingSettings->DirectoriesToAlwaysCook)
+	{
+		FString path = directory.Path;
+		TArray<FAssetData> assets;
+
+		// The editor saves these as /Game/..., but a hand-written entry may be relative to Content.
+		if(!path.StartsWith(TEXT("/")))
+			path = TEXT("/Game/") + path;
+
+		assetRegistry.GetAssetsByPath(FName(*path), assets, true);
+
+		// Likely a stale entry; say so rather than report it as part of the always-cook set.
+		if(assets.Num() == 0)
+			UE_LOG(LogNNP, Warning, TEXT("Always-cook directory %s has no assets"), *path);
+
+		for(const FAssetData& asset : assets)
+			AddPackageRoot(roots, asset.PackageName.ToString());
+	}
+}
+
+// Soft references in one config property value, or in each element of an array of them.
+static void AddSoftPathRoots(TSet<FName>& roots, const FProperty *property, const void *value)
+{
+	const FArrayProperty *arrayProperty = CastField<FArrayProperty>(property);
+	const FSoftObjectProperty *softProperty = CastField<FSoftObjectProperty>(property);
+	const FStructProperty *structProperty = CastField<FStructProperty>(property);
+	FSoftObjectPath path;
+	int32 i;
+
+	if(arrayProperty)
+	{
+		FScriptArrayHelper array(arrayProperty, value);
+
+		for(i = 0; i < array.Num(); i++)
+			AddSoftPathRoots(roots, arrayProperty->Inner, array.GetRawPtr(i));
+		return;
+	}
+
+	if(softProperty)
+		path = softProperty->GetPropertyValue(value).ToSoftObjectPath();
+	else if(structProperty && (structProperty->Struct == TBaseStructure<FSoftObjectPath>::Get() || structProperty->Struct == TBaseStructure<FSoftClassPath>::Get()))
+		path = *(const FSoftObjectPath*)value;
+
+	if(path.IsValid())
+		AddPackageRoot(roots, path.GetLongPackageName());
+}
+
+// Soft references that only config holds, such as the character's
+// +HapticEnvelopes.  No package refers to them, so the registry can't either.
+static void GatherConfigRoots(TSet<FName>& roots)
+{
+	int32 i;
+
+	for(TObjectIterator<UClass> it; it; ++it)
+	{
+		UClass *classObject = *it;
+		UObject *defaults;
+
+		if(!classObject->HasAllClassFlags(CLASS_Native | CLASS_Config) || classObject->HasAnyClassFlags(CLASS_Deprecated | CLASS_NewerVersionExists))
+			continue;
+
+		defaults = classObject->GetDefaultObject();
+		for(TFieldIterator<FProperty> property(classObject); property; ++property)
+		{
+			if(!property->HasAnyPropertyFlags(CPF_Config))
+				continue;
+
+			for(i = 0; i < property->ArrayDim; i++)
+				AddSoftPathRoots(roots, *property, property->ContainerPtrToValuePtr<void>(defaults, i));
+		}
+	}
+}
+
+int32 UNNPContentFootprintCommandlet::Main(const FString& Params)
+{
+	IAssetRegistry& assetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	FString outDir = FPaths::ProjectSavedDir() / TEXT("ContentFootprint");
+	bool measureMemory = FParse::Param(*Params, TEXT("memory"));
+	TArray<FString> tokens;
+	TArray<FString> switches;
+	TSet<FName> roots;
+
+	assetRegistry.SearchAllAssets(true);
+
+	FParse::Value(*Params, TEXT("out="), outDir);
+
+	GatherDefaultRoots(roots);
+	GatherCookSettingsRoots(roots, assetRegistry);
+	GatherConfigRoots(roots);
+
+	// Extra roots for content only reached at runtime, e.g. -root=/Game/Maps/Arena
+	ParseCommandLine(*Params, tokens, switches);
+	for(const FString& option : switches)
+	{
+		if(option.StartsWith(TEXT("root=")))
+			roots.Add(FName(*option.RightChop(5).TrimQuotes()));
+	}
+
+	for(const FName& root : roots)
+		UE_LOG(LogNNP, Display, TEXT("Root: %s"), *root.ToString());
+
+	// Walk hard and soft package references from the roots.
+	TSet<FName> referenced;
+	TArray<FName> queue = roots.Array();
+
+	while(queue.Num())
+	{
+		FName packageName = queue.Pop(false);
+		TArray<FName> dependencies;
+
+		if(referenced.Contains(packageName))
+			continue;
+
+		referenced.Add(packageName);
+
+		assetRegistry.GetDependencies(packageName, dependencies);
+		for(const FName& dependency : dependencies)
+		{
+			if(!referenced.Contains(dependency) && !dependency.ToString().StartsWith(TEXT("/Script/")))
+				queue.Add(dependency);
+		}
+	}
+
+	// Every package under /Game, referenced or not.
+	TArray<FAssetData> assets;
+	TMap<FName, TArray<FAssetData>> packageAssets;
+	TArray<FNNPPackageFootprint> packages;
+
+	assetRegistry.GetAssetsByPath(FName(TEXT("/Game")), assets, true);
+	for(const FAssetData& asset : assets)
+		packageAssets.FindOrAdd(asset.PackageName).Add(asset);
+
+	for(TPair<FName, TArray<FAssetData>>& entry : packageAssets)
+	{
+		FNNPPackageFootprint footprint;
+		FString filename;
+
+		footprint.PackageName = entry.Key;
+		footprint.Folder = FPackageName::GetLongPackagePath(entry.Key.ToString());
+		footprint.DiskBytes = 0;
+		footprint.MemoryBytes = 0;
+		footprint.Referenced = referenced.Contains(entry.Key);
+
+		if(FPackageName::DoesPackageExist(entry.Key.ToString(), nullptr, &filename))
+			footprint.DiskBytes = FMath::Max<int64>(IFileManager::Get().FileSize(*filename), 0);
+
+		if(measureMemory)
+		{
+			for(const FAssetData& asset : entry.Value)
+			{
+				UObject *object = asset.GetAsset();
+				if(object)
+					footprint.MemoryBytes += object->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+			}
+
+			if(packages.Num() % GC_INTERVAL_PACKAGES == 0)
+				CollectGarbage(RF_NoFlags);
+		}
+
+		packages.Add(footprint);
+	}
+
+	packages.Sort([](const FNNPPackageFootprint& a, const FNNPPackageFootprint& b) { return a.DiskBytes > b.DiskBytes; });
+
+	// Per-folder totals, and the same totals over each folder's whole subtree.
+	TMap<FString, FNNPFolderFootprint> folders;
+	TMap<FString, FNNPFolderFootprint> subtrees;
+	FNNPFolderFootprint total = { 0, 0, 0, 0, 0 };
+
+	for(const FNNPPackageFootprint& package : packages)
+	{
+		FNNPFolderFootprint delta = { 1, package.Referenced ? 1 : 0, package.Referenced ? package.DiskBytes : 0, package.Referenced ? 0 : package.DiskBytes, package.MemoryBytes };
+		FString folder = package.Folder;
+
+		folders.FindOrAdd(folder, FNNPFolderFootprint{ 0, 0, 0, 0, 0 });
+		FNNPFolderFootprint& own = folders[folder];
+		own.NumPackages += delta.NumPackages;
+		own.NumReferenced += delta.NumReferenced;
+		own.ReferencedBytes += delta.ReferencedBytes;
+		own.UnreferencedBytes += delta.UnreferencedBytes;
+		own.MemoryBytes += delta.MemoryBytes;
+
+		while(folder.StartsWith(TEXT("/Game/")))
+		{
+			FNNPFolderFootprint& subtree = subtrees.FindOrAdd(folder, FNNPFolderFootprint{ 0, 0, 0, 0, 0 });
+			subtree.NumPackages += delta.NumPackages;
+			subtree.NumReferenced += delta.NumReferenced;
+			subtree.ReferencedBytes += delta.ReferencedBytes;
+			subtree.UnreferencedBytes += delta.UnreferencedBytes;
+			subtree.MemoryBytes += delta.MemoryBytes;
+
+			folder = FPaths::GetPath(folder);
+		}
+
+		total.NumPackages += delta.NumPackages;
+		total.NumReferenced += delta.NumReferenced;
+		total.ReferencedBytes += delta.ReferencedBytes;
+		total.UnreferencedBytes += delta.UnreferencedBytes;
+		total.MemoryBytes += delta.MemoryBytes;
+	}
+
+	folders.KeySort([](const FString& a, const FString& b) { return a < b; });
+
+	UE_LOG(LogNNP, Display, TEXT(""));
+	UE_LOG(LogNNP, Display, TEXT("%-56s %8s %8s %12s %12s %12s"), TEXT("Folder"), TEXT("Packages"), TEXT("Used"), TEXT("Used MB"), TEXT("Unused MB"), TEXT("Memory MB"));
+	for(const TPair<FString, FNNPFolderFootprint>& folder : folders)
+	{
+		UE_LOG(LogNNP, Display, TEXT("%-56s %8d %8d %12.2f %12.2f %12.2f"), *folder.Key, folder.Value.NumPackages, folder.Value.NumReferenced,
+			BYTES_TO_MB(folder.Value.ReferencedBytes), BYTES_TO_MB(folder.Value.UnreferencedBytes), BYTES_TO_MB(folder.Value.MemoryBytes));
+	}
+	UE_LOG(LogNNP, Display, TEXT("%-56s %8d %8d %12.2f %12.2f %12.2f"), TEXT("Total"), total.NumPackages, total.NumReferenced,
+		BYTES_TO_MB(total.ReferencedBytes), BYTES_TO_MB(total.UnreferencedBytes), BYTES_TO_MB(total.MemoryBytes));
+
+	UE_LOG(LogNNP, Display, TEXT(""));
+	UE_LOG(LogNNP, Display, TEXT("Largest packages:"));
+	for(int32 i = 0; i < FMath::Min(packages.Num(), REPORT_MAX_ROWS); i++)
+	{
+		UE_LOG(LogNNP, Display, TEXT("%-72s %10.2f MB %10.2f MB %s"), *packages[i].PackageName.ToString(),
+			BYTES_TO_MB(packages[i].DiskBytes), BYTES_TO_MB(packages[i].MemoryBytes), packages[i].Referenced ? TEXT("") : TEXT("unreferenced"));
+	}
+
+	// Outputs: every package as CSV, the unreferenced list, and the folders that can be left out of the cook.
+	FString csv = TEXT("Package,Folder,DiskBytes,MemoryBytes,Referenced\n");
+	FString unreferencedList;
+	FString neverCook = TEXT("[/Script/UnrealEd.ProjectPackagingSettings]\n");
+	int32 numNeverCook = 0;
+
+	for(const FNNPPackageFootprint& package : packages)
+	{
+		csv += FString::Printf(TEXT("%s,%s,%lld,%lld,%d\n"), *package.PackageName.ToString(), *package.Folder, package.DiskBytes, package.MemoryBytes, package.Referenced ? 1 : 0);
+		if(!package.Referenced)
+			unreferencedList += package.PackageName.ToString() + TEXT("\n");
+	}
+
+	subtrees.KeySort([](const FString& a, const FString& b) { return a < b; });
+	for(const TPair<FString, FNNPFolderFootprint>& subtree : subtrees)
+	{
+		const FNNPFolderFootprint *parent = subtrees.Find(FPaths::GetPath(subtree.Key));
+
+		// Only the topmost folder of each fully unreferenced subtree.
+		if(subtree.Value.NumReferenced > 0 || (parent && parent->NumReferenced == 0))
+			continue;
+
+		neverCook += FString::Printf(TEXT("+DirectoriesToNeverCook=(Path=\"%s\")\n"), *subtree.Key);
+		UE_LOG(LogNNP, Display, TEXT("Never cook %s: %.2f MB"), *subtree.Key, BYTES_TO_MB(subtree.Value.UnreferencedBytes));
+		numNeverCook++;
+	}
+
+	if(!FFileHelper::SaveStringToFile(csv, *(outDir / TEXT("Packages.csv"))) ||
+	   !FFileHelper::SaveStringToFile(unreferencedList, *(outDir / TEXT("UnreferencedPackages.txt"))) ||
+	   !FFileHelper::SaveStringToFile(neverCook, *(outDir / TEXT("CookExclusions.ini"))))
+	{
+		UE_LOG(LogNNP, Error, TEXT("Could not write reports to %s"), *outDir);
+		return 1;
+	}
+
+	UE_LOG(LogNNP, Display, TEXT(""));
+	UE_LOG(LogNNP, Display, TEXT("%d of %d packages referenced; %.2f MB unreferenced, %d folders can be excluded from the cook. Reports in %s"),
+		total.NumReferenced, total.NumPackages, BYTES_TO_MB(total.UnreferencedBytes), numNeverCook, *outDir);
+
+	return 0;
+}
+
+#else
+
+int32 UNNPContentFootprintCommandlet::Main(const FString& Params)
+{
+	UE_LOG(LogNNP, Error, TEXT("NNPContentFootprint needs the editor's asset registry; run it from the editor executable."));
+	return 1;
+}
+
+#endif
@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "NNPContentFootprintCommandlet.generated.h"
+
+/**
+ * Walks the package reference graph from the default maps and game mode, the
+ * packaging settings' always-cook maps and directories, and soft references set
+ * in config, and reports what the project's content costs and which of it is
+ * never used.
+ *
+ * Usage: <Editor>-Cmd NNP_BitFryTestDemo -run=NNPContentFootprint [-root=<package>]... [-memory] [-out=<dir>]
+ *
+ * Logs per-folder and per-package disk size, split into referenced and
+ * unreferenced.  -memory also loads each package to estimate its resource size.
+ * Writes the unreferenced package list and a DirectoriesToNeverCook snippet for
+ * folders with no referenced content to Saved/ContentFootprint, or -out.
+ */
+UCLASS()
+class UNNPContentFootprintCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UNNPContentFootprintCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,141 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NNPHapticBakeCommandlet.h"
+#include "NNP_BitFryTestDemo.h"
+#include "NNPHapticEnvelopeAsset.h"
+
+#if WITH_EDITOR
+#include "Audio.h"
+#include "AssetRegistryModule.h"
+#include "Misc/PackageName.h"
+#include "Sound/SoundWave.h"
+#include "UObject/Package.h"
+#endif
+
+#define HAPTIC_ENVELOPE_PATH TEXT("/Game/Haptics")
+#define HAPTIC_ENVELOPE_PREFIX TEXT("HE_")
+
+UNNPHapticBakeCommandlet::UNNPHapticBakeCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+#if WITH_EDITOR
+
+static const TCHAR *DefaultSounds[] =
+{
+	TEXT("/Game/MobileStarterContent/Audio/Explosion01"),
+	TEXT("/Game/MobileStarterContent/Audio/Explosion02"),
+	TEXT("/Game/MobileStarterContent/Audio/Collapse01"),
+	TEXT("/Game/MobileStarterContent/Audio/Collapse02"),
+	TEXT("/Game/MobileStarterContent/Audio/Fire01"),
+	TEXT("/Game/MobileStarterContent/Audio/Fire_Sparks01"),
+};
+
+// Envelope from the wave's imported source file, which is only kept in the editor.
+static bool ExtractFromWave(USoundWave *wave, float frameRate, FNNPHapticEnvelope &envelope)
+{
+	FWaveModInfo waveInfo;
+	const uint8 *rawData;
+	int32 rawSize = wave->RawData.GetBulkDataSize();
+	bool result = false;
+
+	if(rawSize <= 0)
+	{
+		UE_LOG(LogNNP, Error, TEXT("%s has no source audio"), *wave->GetPathName());
+		return false;
+	}
+
+	rawData = (const uint8*)wave->RawData.LockReadOnly();
+
+	if(!waveInfo.ReadWaveInfo(rawData, rawSize))
+		UE_LOG(LogNNP, Error, TEXT("%s: source audio is not a readable wave file"), *wave->GetPathName());
+	else if(*waveInfo.pBitsPerSample != 16)
+		UE_LOG(LogNNP, Error, TEXT("%s: %d bit audio, only 16 bit is supported"), *wave->GetPathName(), (int32)*waveInfo.pBitsPerSample);
+	else
+	{
+		int32 numChannels = *waveInfo.pChannels;
+		int32 numFrames = waveInfo.SampleDataSize / (sizeof(int16) * numChannels);
+
+		result = FNNPHapticEnvelope::Extract((const int16*)waveInfo.SampleDataStart, numFrames, numChannels, *waveInfo.pSamplesPerSec, frameRate, envelope);
+	}
+
+	wave->RawData.Unlock();
+	return result;
+}
+
+int32 UNNPHapticBakeCommandlet::Main(const FString& Params)
+{
+	FString outPath = HAPTIC_ENVELOPE_PATH;
+	float frameRate = HAPTIC_ENVELOPE_DEFAULT_RATE;
+	TArray<FString> tokens;
+	TArray<FString> switches;
+	TArray<FString> sounds;
+	int32 numFailed = 0;
+
+	FParse::Value(*Params, TEXT("out="), outPath);
+	FParse::Value(*Params, TEXT("rate="), frameRate);
+
+	ParseCommandLine(*Params, tokens, switches);
+	for(const FString& option : switches)
+	{
+		if(option.StartsWith(TEXT("sound=")))
+			sounds.Add(option.RightChop(6).TrimQuotes());
+	}
+
+	if(sounds.Num() == 0)
+	{
+		for(const TCHAR *sound : DefaultSounds)
+			sounds.Add(sound);
+	}
+
+	for(const FString& soundPackage : sounds)
+	{
+		FString soundName = FPackageName::GetShortName(soundPackage);
+		USoundWave *wave = LoadObject<USoundWave>(nullptr, *(soundPackage + TEXT(".") + soundName));
+		FNNPHapticEnvelope envelope;
+
+		if(!wave || !ExtractFromWave(wave, frameRate, envelope))
+		{
+			UE_LOG(LogNNP, Error, TEXT("Could not bake a haptic envelope for %s"), *soundPackage);
+			numFailed++;
+			continue;
+		}
+
+		FString assetName = HAPTIC_ENVELOPE_PREFIX + soundName;
+		FString packageName = outPath / assetName;
+		FString filename = FPackageName::LongPackageNameToFilename(packageName, FPackageName::GetAssetPackageExtension());
+		UPackage *package = CreatePackage(nullptr, *packageName);
+		UNNPHapticEnvelopeAsset *asset = NewObject<UNNPHapticEnvelopeAsset>(package, *assetName, RF_Public | RF_Standalone);
+
+		asset->Sound = wave;
+		asset->Envelope = envelope;
+		FAssetRegistryModule::AssetCreated(asset);
+		package->MarkPackageDirty();
+
+		if(!UPackage::SavePackage(package, asset, RF_Public | RF_Standalone, *filename))
+		{
+			UE_LOG(LogNNP, Error, TEXT("Could not save %s"), *filename);
+			numFailed++;
+			continue;
+		}
+
+		UE_LOG(LogNNP, Display, TEXT("%s: %.2f s of audio, %d frames at %.0f fps, %d bytes"), *packageName,
+			wave->Duration, envelope.NumFrames(), envelope.FrameRate, envelope.Intensity.Num() + envelope.Sharpness.Num());
+	}
+
+	return numFailed ? 1 : 0;
+}
+
+#else
+
+int32 UNNPHapticBakeCommandlet::Main(const FString& Params)
+{
+	UE_LOG(LogNNP, Error, TEXT("NNPHapticBake needs the source audio kept by the editor; run it from the editor executable."));
+	return 1;
+}
+
+#endif
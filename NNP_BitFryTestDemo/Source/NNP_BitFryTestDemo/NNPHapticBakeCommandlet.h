@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "NNPHapticBakeCommandlet.generated.h"
+
+/**
+ * Bakes haptic envelopes from sound waves.
+ *
+ * Usage: <Editor>-Cmd NNP_BitFryTestDemo -run=NNPHapticBake [-sound=<package>]... [-rate=<fps>] [-out=<path>]
+ *
+ * Analyzes each sound's source audio once and saves the result as a
+ * UNNPHapticEnvelopeAsset named HE_<sound> under -out, /Game/Haptics by default.
+ * With no -sound the starter content explosions, collapses and fires are baked.
+ */
+UCLASS()
+class UNNPHapticBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UNNPHapticBakeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
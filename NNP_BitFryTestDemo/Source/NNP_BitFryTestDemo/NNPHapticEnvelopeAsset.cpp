@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NNPHapticEnvelopeAsset.h"
+#include "NNP_BitFryTestDemo.h"
+#include "Serialization/CustomVersion.h"
+
+// Layout of the envelope bytes in a baked asset.  Add a version before
+// LatestPlusOne for every change, and keep reading the older ones.
+struct FNNPHapticEnvelopeVersion
+{
+	enum Type
+	{
+		// Frame rate, intensity and sharpness, one byte per frame.
+		Initial = 1,
+
+		LatestPlusOne,
+		Latest = LatestPlusOne - 1
+	};
+
+	static const FGuid GUID;
+};
+
+const FGuid FNNPHapticEnvelopeVersion::GUID(0x5C1B7E42, 0x8D3A4F96, 0xA2E0C417, 0x6B95D3F8);
+
+static FCustomVersionRegistration GRegisterNNPHapticEnvelopeVersion(FNNPHapticEnvelopeVersion::GUID, FNNPHapticEnvelopeVersion::Latest, TEXT("NNPHapticEnvelope"));
+
+void UNNPHapticEnvelopeAsset::Serialize(FArchive& Ar)
+{
+	int32 version;
+
+	Super::Serialize(Ar);
+
+	Ar.UsingCustomVersion(FNNPHapticEnvelopeVersion::GUID);
+	version = Ar.CustomVer(FNNPHapticEnvelopeVersion::GUID);
+
+	// Saved before the envelope bytes carried a version, or by a newer build: the
+	// layout isn't known, so leave the envelope empty rather than misread it.
+	if(Ar.IsLoading() && (version < FNNPHapticEnvelopeVersion::Initial || version > FNNPHapticEnvelopeVersion::Latest))
+	{
+		UE_LOG(LogNNP, Error, TEXT("%s: haptic envelope version %d is not supported, rebake it with NNPHapticBake"), *GetPathName(), version);
+		Envelope = FNNPHapticEnvelope();
+		return;
+	}
+
+	Ar << Envelope;
+}
@@ -0,0 +1,32 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "NNPHapticEnvelope.h"
+#include "NNPHapticEnvelopeAsset.generated.h"
+
+class USoundWave;
+
+/**
+ * A baked haptic envelope and the sound it was baked from.  Made by the
+ * NNPHapticBake commandlet; the curves are serialized as raw bytes behind a
+ * custom version, and assets with a version this build can't read load empty.
+ */
+UCLASS()
+class NNP_BITFRYTESTDEMO_API UNNPHapticEnvelopeAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/** The sound this envelope plays along with. */
+	UPROPERTY(VisibleAnywhere, Category = Haptics)
+	TSoftObjectPtr<USoundWave> Sound;
+
+	FNNPHapticEnvelope Envelope;
+
+	// UObject interface
+	virtual void Serialize(FArchive& Ar) override;
+	// End of UObject interface
+};
@@ -0,0 +1,187 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NNPLevelStreamingManager.h"
+#include "NNP_BitFryTestDemo.h"
+#include "Engine/LevelStreaming.h"
+#include "GameFramework/Character.h"
+#include "Kismet/GameplayStatics.h"
+#include "Kismet/KismetSystemLibrary.h"
+#include "Misc/CommandLine.h"
+
+#define TRAVERSAL_WAYPOINT_RADIUS 50.0f
+// Reading memory stats can mean parsing /proc, so the traversal samples it a few times a second.
+#define MEMORY_SAMPLE_SECONDS 0.25f
+
+ANNPLevelStreamingManager::ANNPLevelStreamingManager()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	// Tick after movement so we test where the character ended up this frame.
+	PrimaryActorTick.TickGroup = TG_PostPhysics;
+
+	StallThresholdSeconds = 0.05f;
+	TraversalSpeed = 600.0f;
+
+	bTraversing = false;
+	bTraversalRun = false;
+	TraversalIndex = 0;
+	MemorySampleSeconds = 0.0f;
+	PeakUsedPhysical = 0;
+	NumLoadRequests = 0;
+	NumUnloadRequests = 0;
+	NumStallFrames = 0;
+	WorstStallSeconds = 0.0f;
+}
+
+void ANNPLevelStreamingManager::BeginPlay()
+{
+	Super::BeginPlay();
+
+	for(FNNPStreamingCell& cell : Cells)
+	{
+		cell.StreamingLevel = UGameplayStatics::GetStreamingLevel(this, cell.LevelName);
+
+		// Start from the sublevel's own state, so one that starts loaded out of range is unloaded.
+		cell.bWantsLoaded = cell.StreamingLevel && cell.StreamingLevel->ShouldBeLoaded();
+
+		if(!cell.StreamingLevel)
+			UE_LOG(LogNNP, Warning, TEXT("Streaming: %s is not a streaming sublevel of %s"), *cell.LevelName.ToString(), *GetWorld()->GetMapName());
+
+		if(cell.UnloadRadius <= cell.LoadRadius)
+			cell.UnloadRadius = cell.LoadRadius * 1.2f;
+	}
+
+	bTraversing = TraversalPath.Num() > 0 && FParse::Param(FCommandLine::Get(), TEXT("NNPStreamingTraversal"));
+	bTraversalRun = bTraversing;
+	TraversalIndex = 0;
+	MemorySampleSeconds = 0.0f;
+}
+
+void ANNPLevelStreamingManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Only the traversal measures anything worth reporting.
+	if(bTraversalRun)
+		LogReport();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ANNPLevelStreamingManager::Tick(float DeltaSeconds)
+{
+	ACharacter *character;
+
+	Super::Tick(DeltaSeconds);
+
+	// A long frame while something is still streaming is a load stall.
+	if(IsAnyCellPending() && DeltaSeconds > StallThresholdSeconds)
+	{
+		NumStallFrames++;
+		WorstStallSeconds = FMath::Max(WorstStallSeconds, DeltaSeconds);
+	}
+
+	if(bTraversing)
+	{
+		MemorySampleSeconds -= DeltaSeconds;
+		if(MemorySampleSeconds <= 0.0f)
+		{
+			PeakUsedPhysical = FMath::Max<uint64>(PeakUsedPhysical, FPlatformMemory::GetStats().UsedPhysical);
+			MemorySampleSeconds = MEMORY_SAMPLE_SECONDS;
+		}
+
+		UpdateTraversal(DeltaSeconds);
+	}
+
+	character = UGameplayStatics::GetPlayerCharacter(this, 0);
+	if(character)
+		UpdateCells(character->GetActorLocation());
+}
+
+void ANNPLevelStreamingManager::UpdateCells(const FVector& location)
+{
+	for(FNNPStreamingCell& cell : Cells)
+	{
+		if(!cell.StreamingLevel)
+			continue;
+
+		float distSq = FVector::DistSquared2D(FVector(cell.Center, 0.0f), location);
+		bool wantsLoaded = cell.bWantsLoaded;
+
+		// Between the two radii the cell keeps whatever state it already has.
+		if(distSq < cell.LoadRadius * cell.LoadRadius)
+			wantsLoaded = true;
+		else if(distSq > cell.UnloadRadius * cell.UnloadRadius)
+			wantsLoaded = false;
+
+		if(wantsLoaded == cell.bWantsLoaded)
+			continue;
+
+		// The streaming level loads and unloads asynchronously from here on.
+		cell.bWantsLoaded = wantsLoaded;
+		cell.StreamingLevel->SetShouldBeLoaded(wantsLoaded);
+		cell.StreamingLevel->SetShouldBeVisible(wantsLoaded);
+
+		if(wantsLoaded)
+			NumLoadRequests++;
+		else
+			NumUnloadRequests++;
+	}
+}
+
+bool ANNPLevelStreamingManager::IsAnyCellPending() const
+{
+	for(const FNNPStreamingCell& cell : Cells)
+	{
+		if(cell.StreamingLevel && cell.StreamingLevel->IsStreamingStatePending())
+			return true;
+	}
+
+	return false;
+}
+
+void ANNPLevelStreamingManager::UpdateTraversal(float DeltaSeconds)
+{
+	ACharacter *character = UGameplayStatics::GetPlayerCharacter(this, 0);
+
+	if(!character)
+		return;
+
+	if(TraversalIndex >= TraversalPath.Num())
+	{
+		// Wait for the last cells to settle so their stalls are counted too.
+		// EndPlay logs the report on the way out.
+		if(!IsAnyCellPending())
+		{
+			bTraversing = false;
+			UKismetSystemLibrary::QuitGame(this, nullptr, EQuitPreference::Quit, false);
+		}
+		return;
+	}
+
+	FVector location = character->GetActorLocation();
+	FVector target = TraversalPath[TraversalIndex];
+	FVector toTarget = target - location;
+	float step = TraversalSpeed * DeltaSeconds;
+
+	toTarget.Z = 0.0f;
+	if(toTarget.Size() <= FMath::Max(step, TRAVERSAL_WAYPOINT_RADIUS))
+	{
+		character->SetActorLocation(FVector(target.X, target.Y, location.Z));
+		TraversalIndex++;
+	}
+	else
+		character->SetActorLocation(location + toTarget.GetSafeNormal() * step);
+}
+
+void ANNPLevelStreamingManager::LogReport() const
+{
+	int32 numLoaded = 0;
+
+	for(const FNNPStreamingCell& cell : Cells)
+	{
+		if(cell.StreamingLevel && cell.StreamingLevel->IsLevelLoaded())
+			numLoaded++;
+	}
+
+	UE_LOG(LogNNP, Display, TEXT("Streaming: %d/%d cells loaded, %d load and %d unload requests"), numLoaded, Cells.Num(), NumLoadRequests, NumUnloadRequests);
+	UE_LOG(LogNNP, Display, TEXT("Streaming: peak used physical memory %.1f MB"), PeakUsedPhysical / (1024.0 * 1024.0));
+	UE_LOG(LogNNP, Display, TEXT("Streaming: %d load stalls over %.0f ms, worst %.1f ms"), NumStallFrames, StallThresholdSeconds * 1000.0f, WorstStallSeconds * 1000.0f);
+}
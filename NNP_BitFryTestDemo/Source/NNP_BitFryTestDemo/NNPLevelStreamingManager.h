@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "NNPLevelStreamingManager.generated.h"
+
+class ULevelStreaming;
+
+/** A sublevel that is streamed in and out around the player. */
+USTRUCT(BlueprintType)
+struct FNNPStreamingCell
+{
+	GENERATED_BODY()
+
+	/** Name of the streaming sublevel, as listed in the persistent level's Levels window. */
+	UPROPERTY(EditAnywhere, Category = Streaming)
+	FName LevelName;
+
+	/** 2D center of the cell in world space. */
+	UPROPERTY(EditAnywhere, Category = Streaming)
+	FVector2D Center = FVector2D::ZeroVector;
+
+	/** The cell starts loading when the character comes closer than this. */
+	UPROPERTY(EditAnywhere, Category = Streaming)
+	float LoadRadius = 5000.0f;
+
+	/** The cell unloads once the character is further than this.  Must be larger than LoadRadius. */
+	UPROPERTY(EditAnywhere, Category = Streaming)
+	float UnloadRadius = 6000.0f;
+
+	/** Resolved from LevelName in BeginPlay. */
+	UPROPERTY(Transient)
+	ULevelStreaming *StreamingLevel = nullptr;
+
+	bool bWantsLoaded = false;
+};
+
+/**
+ * Loads and unloads sublevel cells asynchronously based on the player character's
+ * 2D distance, with separate load and unload radii so a character standing on a
+ * boundary doesn't thrash the cell.
+ *
+ * Place one in the persistent level and list its streaming sublevels in Cells.
+ * Run with -NNPStreamingTraversal to walk the character along TraversalPath,
+ * log peak memory and load stalls, and quit.  Nothing is logged otherwise.
+ */
+UCLASS()
+class NNP_BITFRYTESTDEMO_API ANNPLevelStreamingManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ANNPLevelStreamingManager();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	UPROPERTY(EditAnywhere, Category = Streaming)
+	TArray<FNNPStreamingCell> Cells;
+
+	/** Frames longer than this while a cell is loading count as load stalls. */
+	UPROPERTY(EditAnywhere, Category = Streaming)
+	float StallThresholdSeconds;
+
+	/** Waypoints for the scripted traversal. */
+	UPROPERTY(EditAnywhere, Category = "Streaming|Traversal")
+	TArray<FVector> TraversalPath;
+
+	/** Speed of the scripted traversal in units per second. */
+	UPROPERTY(EditAnywhere, Category = "Streaming|Traversal")
+	float TraversalSpeed;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	void UpdateCells(const FVector& location);
+	bool IsAnyCellPending() const;
+	void UpdateTraversal(float DeltaSeconds);
+	void LogReport() const;
+
+	bool bTraversing;
+	// Still true once the traversal has finished, so EndPlay knows to report it.
+	bool bTraversalRun;
+	int32 TraversalIndex;
+	float MemorySampleSeconds;
+
+	uint64 PeakUsedPhysical;
+	int32 NumLoadRequests;
+	int32 NumUnloadRequests;
+	int32 NumStallFrames;
+	float WorstStallSeconds;
+};
@@ -71,6 +71,8 @@ void ANNPPlayerController::ToggleHardwareController(bool useHardware)
 		{
 			// NNP: Set button press callbacks here.
 			[Controller.extendedGamepad.buttonA setValueChangedHandler:^(GCControllerButtonInput *button, float value, BOOL pressed) {
+				NotifyInputEvent();
+				
 				// Update button pressed information...
 				if(pressed)
 					Buttons[AButton] = value;
@@ -83,6 +85,8 @@ void ANNPPlayerController::ToggleHardwareController(bool useHardware)
 				//	GEngine->AddOnScreenDebugMessage(-1, 15.0f, FColor::Yellow, FString::Printf(TEXT("A Button: %f, pressed: %i"), value, pressed));
 			}];
 			[Controller.extendedGamepad.buttonB setValueChangedHandler:^(GCControllerButtonInput *button, float value, BOOL pressed) {
+				NotifyInputEvent();
+				
 				// Update button pressed information...
 				if(pressed)
 					Buttons[BButton] = value;
@@ -92,6 +96,8 @@ void ANNPPlayerController::ToggleHardwareController(bool useHardware)
 				ButtonActions[BButton](BButton, CallingObject[BButton], pressed);
 			}];
 			[Controller.extendedGamepad.buttonX setValueChangedHandler:^(GCControllerButtonInput *button, float value, BOOL pressed) {
+				NotifyInputEvent();
+				
 				// Update button pressed information...
 				if(pressed)
 					Buttons[XButton] = value;
@@ -102,6 +108,8 @@ void ANNPPlayerController::ToggleHardwareController(bool useHardware)
 				
 			}];
 			[Controller.extendedGamepad.buttonY setValueChangedHandler:^(GCControllerButtonInput *button, float value, BOOL pressed) {
+				NotifyInputEvent();
+				
 				// Update button pressed information...
 				if(pressed)
 					Buttons[YButton] = value;
@@ -113,6 +121,8 @@ void ANNPPlayerController::ToggleHardwareController(bool useHardware)
 			
 			// NNP: setup shoulder and trigger button press callbacks here.
 			[Controller.extendedGamepad.leftShoulder setValueChangedHandler:^(GCControllerButtonInput *button, float value, BOOL pressed) {
+				NotifyInputEvent();
+				
 				// Update button pressed information...
 				if(pressed)
 					Buttons[LShoulder] = value;
@@ -122,6 +132,8 @@ void ANNPPlayerController::ToggleHardwareController(bool useHardware)
 				ButtonActions[LShoulder](LShoulder, CallingObject[LShoulder], pressed);
 			}];
 			[Controller.extendedGamepad.rightShoulder setValueChangedHandler:^(GCControllerButtonInput *button, float value, BOOL pressed) {
+				NotifyInputEvent();
+				
 				// Update button pressed information...
 				if(pressed)
 					Buttons[RShoulder] = value;
@@ -131,6 +143,8 @@ void ANNPPlayerController::ToggleHardwareController(bool useHardware)
 				ButtonActions[RShoulder](RShoulder, CallingObject[RShoulder], pressed);
 			}];
 			[Controller.extendedGamepad.leftTrigger setValueChangedHandler:^(GCControllerButtonInput *button, float value, BOOL pressed) {
+				NotifyInputEvent();
+				
 				// Update button pressed information...
 				if(pressed)
 					Buttons[LTrigger] = value;
@@ -140,6 +154,8 @@ void ANNPPlayerController::ToggleHardwareController(bool useHardware)
 				ButtonActions[LTrigger](LTrigger, CallingObject[LTrigger], pressed);
 			}];
 			[Controller.extendedGamepad.rightTrigger setValueChangedHandler:^(GCControllerButtonInput *button, float value, BOOL pressed) {
+				NotifyInputEvent();
+				
 				// Update button pressed information...
 				if(pressed)
 					Buttons[RTrigger] = value;
@@ -151,12 +167,16 @@ void ANNPPlayerController::ToggleHardwareController(bool useHardware)
 			
 			// NNP: Set the thumbstick callbacks here.
 			[Controller.extendedGamepad.leftThumbstick setValueChangedHandler:^(GCControllerDirectionPad *dPad, float xValue, float yValue){
+				NotifyInputEvent();
+				
 				// Update our internal value for the left thumbstick.
 				LThumbstick.X = xValue;
 				LThumbstick.Y = yValue;
 			}];
 			
 			[Controller.extendedGamepad.rightThumbstick setValueChangedHandler:^(GCControllerDirectionPad *dPad, float xValue, float yValue){
+				NotifyInputEvent();
+				
 				// Update our internal value for the left thumbstick.
 				RThumbstick.X = xValue;
 				RThumbstick.Y = yValue;
@@ -240,6 +260,8 @@ void ANNPPlayerController::SetTouchstick(APlayerController *controller)
 	
 	if(isPressed)
 	{
+		NotifyInputEvent();
+		
 		if(Touchsticks[index].FirstTouch)
 		{
 			Touchsticks[index].FirstTouch = false;
@@ -295,11 +317,27 @@ float ANNPPlayerController::GetButton(NNPButtons button)
 	return Buttons[button];
 }
 
+// Count an input event for this frame's telemetry.  Safe to call from the
+// GameController handlers, which run on the main thread rather than the game thread.
+void ANNPPlayerController::NotifyInputEvent()
+{
+	InputEventCount.Increment();
+}
+
+// Get the number of input events and haptics updates since the last call, and reset them.
+void ANNPPlayerController::ConsumeFrameCounters(int32 &inputEvents, int32 &hapticsUpdates)
+{
+	inputEvents = InputEventCount.Set(0);
+	hapticsUpdates = HapticsUpdateCount.Set(0);
+}
+
 // Update Haptics
 void ANNPPlayerController::UpdateHaptics(float intensity, float sharpness)
 {
 	NSError *error = nil;
 	
+	HapticsUpdateCount.Increment();
+	
 	CHHapticEventParameter *intensityParam = [[CHHapticEventParameter alloc] initWithParameterID:CHHapticEventParameterIDHapticIntensity value:intensity];
 	CHHapticEventParameter *sharpnessParam = [[CHHapticEventParameter alloc] initWithParameterID:CHHapticEventParameterIDHapticSharpness value:sharpness];
 	NSArray *parameters = [NSArray arrayWithObjects:intensityParam, sharpnessParam, nil];
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "NNPHapticStreamer.h"
 #include "NNPPlayerController.generated.h"
 
 @class GCController;
@@ -57,7 +59,7 @@ typedef void (*ButtonAction)(NNPButtons button, void *object, bool pressed);
  * 
  */
 UCLASS()
-class NNP_BITFRYTESTDEMO_API ANNPPlayerController : public APlayerController
+class NNP_BITFRYTESTDEMO_API ANNPPlayerController : public APlayerController, public INNPHapticsBackend
 {
 	GENERATED_BODY()
 	
@@ -94,7 +96,12 @@ public:
 	float GetButton(NNPButtons button);
 	
 	// Update Haptics
-	void UpdateHaptics(float intensity, float sharpness);
+	virtual void UpdateHaptics(float intensity, float sharpness) override;
+	
+	// Count an input event for this frame's telemetry.
+	void NotifyInputEvent();
+	// Get the number of input events and haptics updates since the last call, and reset them.
+	void ConsumeFrameCounters(int32 &inputEvents, int32 &hapticsUpdates);
 	
 protected:
 	GCController *Controller;
@@ -113,6 +120,10 @@ protected:
 	FVector2D LThumbstick;
 	FRotator ControllerOrientation;
 	
+	// Per-frame telemetry counters.  Input handlers run on the main thread.
+	FThreadSafeCounter InputEventCount;
+	FThreadSafeCounter HapticsUpdateCount;
+	
 	void InitializeHaptics() API_AVAILABLE(ios(14));
 	
 };
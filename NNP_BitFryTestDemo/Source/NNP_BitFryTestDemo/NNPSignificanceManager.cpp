@@ -0,0 +1,309 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NNPSignificanceManager.h"
+#include "NNP_BitFryTestDemo.h"
+#include "NNP_BitFryTestDemoCharacter.h"
+#include "NNP_BitFryTestDemoGameMode.h"
+#include "NNPAnimInstance.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/App.h"
+#include "RenderCore.h"
+
+#define RECENTLY_RENDERED_SECONDS 0.25f
+#define BENCHMARK_WARMUP_FRAMES 120
+#define CROWD_SPACING 300.0f
+
+// Tick interval of each bucket, in target frame times; multiplied by the target
+// frame time to get the interval in seconds that the character ticks at.  The
+// buckets are named for the frame cadence at the target frame rate, but they are
+// intervals: at half the target rate, Every2nd_Bucket ticks every frame and
+// Every4th_Bucket every 2nd.  Half a frame short of the whole number so timing
+// jitter can't push a tick out to the following frame.
+static const float BucketIntervals[MAX_TICK_BUCKETS] = { 0.0f, 1.5f, 3.5f, 0.0f };
+
+ANNPSignificanceManager::ANNPSignificanceManager()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PrePhysics;
+
+	NearDistance = 1500.0f;
+	MidDistance = 4000.0f;
+	FarDistance = 10000.0f;
+	FramesPerSweep = 4;
+
+	NextEntry = 0;
+	bEnabled = true;
+
+	BenchmarkPhase = Idle_Phase;
+	BenchmarkFrames = 0;
+	BenchmarkFramesLeft = 0;
+	BenchmarkGameThreadMs = 0.0;
+	BenchmarkAnimGatherMs = 0.0;
+	BenchmarkAnimWorkerMs = 0.0;
+	BenchmarkOffMs = 0.0;
+}
+
+void ANNPSignificanceManager::RegisterCharacter(ANNP_BitFryTestDemoCharacter *character)
+{
+	FSignificanceEntry entry;
+
+	for(const FSignificanceEntry& existing : Entries)
+	{
+		if(existing.Character == character)
+			return;
+	}
+
+	// Nothing applied yet, so the first sweep always pushes a bucket to it.
+	entry.Character = character;
+	entry.Bucket = INDEX_NONE;
+	entry.TickInterval = 0.0f;
+	entry.bLocal = false;
+	Entries.Add(entry);
+}
+
+void ANNPSignificanceManager::UnregisterCharacter(ANNP_BitFryTestDemoCharacter *character)
+{
+	int32 i;
+
+	for(i = 0; i < Entries.Num(); i++)
+	{
+		if(Entries[i].Character == character)
+		{
+			Entries.RemoveAtSwap(i);
+			break;
+		}
+	}
+}
+
+void ANNPSignificanceManager::Tick(float DeltaSeconds)
+{
+	ANNP_BitFryTestDemoGameMode *gameMode = GetWorld()->GetAuthGameMode<ANNP_BitFryTestDemoGameMode>();
+	APlayerController *player = GetWorld()->GetFirstPlayerController();
+	FVector viewLocation = FVector::ZeroVector;
+	FRotator viewRotation;
+	float frameSeconds = 1.0f / 60.0f;
+	float minInterval = 0.0f;
+	int32 count;
+	int32 i;
+
+	Super::Tick(DeltaSeconds);
+
+	if(BenchmarkPhase != Idle_Phase)
+		UpdateBenchmark(DeltaSeconds);
+
+	if(!bEnabled || Entries.Num() == 0)
+		return;
+
+	if(player)
+		player->GetPlayerViewPoint(viewLocation, viewRotation);
+
+	// The scalability governor may ask for a slower floor for everyone but the player.
+	// Not while benchmarking, or the savings would include the governor's as well.
+	if(gameMode)
+	{
+		frameSeconds = gameMode->TargetFrameTimeMs / 1000.0f;
+		if(BenchmarkPhase == Idle_Phase)
+			minInterval = gameMode->GetCharacterTickInterval();
+	}
+
+	count = FMath::DivideAndRoundUp(Entries.Num(), FMath::Max(FramesPerSweep, 1));
+	for(i = 0; i < count; i++)
+	{
+		if(NextEntry >= Entries.Num())
+			NextEntry = 0;
+
+		UpdateEntry(Entries[NextEntry++], viewLocation, frameSeconds, minInterval);
+	}
+}
+
+void ANNPSignificanceManager::UpdateEntry(FSignificanceEntry& entry, const FVector& viewLocation, float frameSeconds, float minInterval)
+{
+	ANNP_BitFryTestDemoCharacter *character = entry.Character;
+	bool local = character->IsLocalPlayer();
+	int32 bucket;
+	float interval;
+
+	if(local)
+	{
+		bucket = EveryFrame_Bucket;
+		interval = 0.0f;
+	}
+	else
+	{
+		float distSq = FVector::DistSquared(viewLocation, character->GetActorLocation());
+
+		if(distSq < NearDistance * NearDistance)
+			bucket = EveryFrame_Bucket;
+		else if(distSq < MidDistance * MidDistance)
+			bucket = Every2nd_Bucket;
+		else if(distSq < FarDistance * FarDistance)
+			bucket = Every4th_Bucket;
+		else
+			bucket = Dormant_Bucket;
+
+		// Off screen costs one bucket.  Nothing is ever rendered without a renderer
+		// (-nullrhi), so there it's distance alone.
+		if(bucket != Dormant_Bucket && FApp::CanEverRender() && !character->WasRecentlyRendered(RECENTLY_RENDERED_SECONDS))
+			bucket++;
+
+		interval = FMath::Max(BucketIntervals[bucket] * frameSeconds, minInterval);
+	}
+
+	if(bucket == entry.Bucket && interval == entry.TickInterval && local == entry.bLocal)
+		return;
+
+	entry.Bucket = bucket;
+	entry.TickInterval = interval;
+	entry.bLocal = local;
+	// Headless, OnlyTickMontagesWhenNotRendered would skip nearly all anim work, so
+	// the benchmark keeps every character posing to measure the update-rate path.
+	character->ApplySignificance(bucket == Dormant_Bucket, interval, BenchmarkPhase != Idle_Phase);
+}
+
+void ANNPSignificanceManager::SetEnabled(bool enabled)
+{
+	bEnabled = enabled;
+
+	// Put everyone back to full rate; the next sweeps rescore them if enabled.
+	for(FSignificanceEntry& entry : Entries)
+	{
+		entry.Bucket = EveryFrame_Bucket;
+		entry.TickInterval = 0.0f;
+		entry.bLocal = entry.Character->IsLocalPlayer();
+		entry.Character->ApplySignificance(false, 0.0f);
+	}
+}
+
+void ANNPSignificanceManager::LogReport() const
+{
+	int32 counts[MAX_TICK_BUCKETS] = { 0 };
+
+	for(const FSignificanceEntry& entry : Entries)
+	{
+		if(entry.Bucket >= 0 && entry.Bucket < MAX_TICK_BUCKETS)
+			counts[entry.Bucket]++;
+	}
+
+	UE_LOG(LogNNP, Display, TEXT("Significance: %d characters, every frame %d, every 2nd %d, every 4th %d, dormant %d"),
+		Entries.Num(), counts[EveryFrame_Bucket], counts[Every2nd_Bucket], counts[Every4th_Bucket], counts[Dormant_Bucket]);
+}
+
+void ANNPSignificanceManager::SpawnCrowd(int32 numPawns)
+{
+	ANNP_BitFryTestDemoGameMode *gameMode = GetWorld()->GetAuthGameMode<ANNP_BitFryTestDemoGameMode>();
+	APawn *player = GetWorld()->GetFirstPlayerController() ? GetWorld()->GetFirstPlayerController()->GetPawn() : nullptr;
+	FVector origin = player ? player->GetActorLocation() : FVector::ZeroVector;
+	int32 side = FMath::CeilToInt(FMath::Sqrt((float)numPawns));
+	FActorSpawnParameters params;
+	int32 i;
+
+	if(!gameMode || !gameMode->DefaultPawnClass)
+		return;
+
+	params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	// A square grid centered on the player reaches from the near bucket out past the far one at 1000 pawns.
+	for(i = 0; i < numPawns; i++)
+	{
+		FVector offset((i % side - side / 2) * CROWD_SPACING, (i / side - side / 2) * CROWD_SPACING, 0.0f);
+		APawn *pawn = GetWorld()->SpawnActor<APawn>(gameMode->DefaultPawnClass, origin + offset, FRotator::ZeroRotator, params);
+
+		if(pawn)
+			pawn->SpawnDefaultController();
+	}
+}
+
+void ANNPSignificanceManager::StartBenchmark(int32 numPawns, int32 numFrames)
+{
+	SpawnCrowd(numPawns);
+
+	UE_LOG(LogNNP, Display, TEXT("Significance benchmark: %d characters, %d frames per run"), Entries.Num(), numFrames);
+	if(!FApp::CanEverRender())
+		UE_LOG(LogNNP, Display, TEXT("Significance benchmark: not rendering, so characters are scored on distance only"));
+	UE_LOG(LogNNP, Display, TEXT("Significance benchmark: every character ticks its pose while it runs, rendered or not"));
+	UE_LOG(LogNNP, Display, TEXT("Significance benchmark: the scalability governor's character tick floor is ignored while it runs"));
+
+	SetEnabled(false);
+	BenchmarkFrames = FMath::Max(numFrames, 1);
+	BenchmarkFramesLeft = BENCHMARK_WARMUP_FRAMES;
+	BenchmarkPhase = WarmupOff_Phase;
+}
+
+void ANNPSignificanceManager::UpdateBenchmark(float DeltaSeconds)
+{
+	int64 gatherCycles;
+	int64 workerCycles;
+
+	UNNPAnimInstance::ConsumeCycles(gatherCycles, workerCycles);
+
+	// GGameThreadTime is the previous frame's game thread time.
+	if(BenchmarkPhase == MeasureOff_Phase || BenchmarkPhase == MeasureOn_Phase)
+	{
+		BenchmarkGameThreadMs += FPlatformTime::ToMilliseconds(GGameThreadTime);
+		BenchmarkAnimGatherMs += FPlatformTime::ToMilliseconds64(gatherCycles);
+		BenchmarkAnimWorkerMs += FPlatformTime::ToMilliseconds64(workerCycles);
+	}
+
+	if(--BenchmarkFramesLeft > 0)
+		return;
+
+	switch(BenchmarkPhase)
+	{
+		case WarmupOff_Phase:
+			BenchmarkPhase = MeasureOff_Phase;
+			BenchmarkFramesLeft = BenchmarkFrames;
+			BenchmarkGameThreadMs = 0.0;
+			BenchmarkAnimGatherMs = 0.0;
+			BenchmarkAnimWorkerMs = 0.0;
+			break;
+
+		case MeasureOff_Phase:
+			LogBenchmarkRun(TEXT("without significance"));
+			BenchmarkOffMs = BenchmarkGameThreadMs / BenchmarkFrames;
+			SetEnabled(true);
+			BenchmarkPhase = WarmupOn_Phase;
+			BenchmarkFramesLeft = BENCHMARK_WARMUP_FRAMES;
+			break;
+
+		case WarmupOn_Phase:
+			BenchmarkPhase = MeasureOn_Phase;
+			BenchmarkFramesLeft = BenchmarkFrames;
+			BenchmarkGameThreadMs = 0.0;
+			BenchmarkAnimGatherMs = 0.0;
+			BenchmarkAnimWorkerMs = 0.0;
+			break;
+
+		case MeasureOn_Phase:
+		{
+			double onMs = BenchmarkGameThreadMs / BenchmarkFrames;
+
+			LogBenchmarkRun(TEXT("with significance"));
+			UE_LOG(LogNNP, Display, TEXT("Significance benchmark: %d characters, game thread %.2f ms without significance, %.2f ms with, saved %.2f ms (%.0f%%)"),
+				Entries.Num(), BenchmarkOffMs, onMs, BenchmarkOffMs - onMs, BenchmarkOffMs > 0.0 ? 100.0 * (BenchmarkOffMs - onMs) / BenchmarkOffMs : 0.0);
+			LogReport();
+			BenchmarkPhase = Idle_Phase;
+			
+			// Push everyone's bucket again, this time with normal posing rules.
+			for(FSignificanceEntry& entry : Entries)
+				entry.Bucket = INDEX_NONE;
+			break;
+		}
+
+		default:
+			BenchmarkPhase = Idle_Phase;
+			break;
+	}
+}
+
+void ANNPSignificanceManager::LogBenchmarkRun(const TCHAR *name) const
+{
+	ANNP_BitFryTestDemoGameMode *gameMode = GetWorld()->GetAuthGameMode<ANNP_BitFryTestDemoGameMode>();
+
+	// Worker time is summed over all threads, so it can exceed the frame.
+	UE_LOG(LogNNP, Display, TEXT("Significance benchmark %s: game thread %.2f ms, anim gather %.3f ms, anim update and evaluate %.3f ms per frame"),
+		name, BenchmarkGameThreadMs / BenchmarkFrames, BenchmarkAnimGatherMs / BenchmarkFrames, BenchmarkAnimWorkerMs / BenchmarkFrames);
+
+	// The governor still scales rendering, so runs at different levels aren't comparable.
+	if(gameMode)
+		UE_LOG(LogNNP, Display, TEXT("Significance benchmark %s: scalability level %d at the end of the run"), name, gameMode->GetScalabilityLevel());
+}
@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "NNPSignificanceManager.generated.h"
+
+class ANNP_BitFryTestDemoCharacter;
+
+typedef enum NNP_TICK_BUCKETS
+{
+	EveryFrame_Bucket = 0,
+	Every2nd_Bucket,
+	Every4th_Bucket,
+	Dormant_Bucket,
+
+	MAX_TICK_BUCKETS
+} NNPTickBuckets;
+
+// Benchmark: warm up then measure with significance off, then the same with it on.
+typedef enum NNP_BENCHMARK_PHASES
+{
+	Idle_Phase = 0,
+	WarmupOff_Phase,
+	MeasureOff_Phase,
+	WarmupOn_Phase,
+	MeasureOn_Phase
+} NNPBenchmarkPhases;
+
+/**
+ * Scores characters by distance from the view and whether they were recently
+ * rendered, and puts each one in a tick bucket.  The local player is always in
+ * EveryFrame_Bucket.  Without a renderer only distance counts.
+ *
+ * Buckets are named for how often they tick at the game mode's target frame
+ * rate, but they set a tick interval in seconds, so at a lower frame rate the
+ * slower buckets tick on more of the frames than their names say.
+ *
+ * Each frame only a slice of the characters is rescored, so bucket changes, and
+ * the tick phases that follow from them, are spread over several frames instead
+ * of landing all at once.
+ */
+UCLASS()
+class NNP_BITFRYTESTDEMO_API ANNPSignificanceManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ANNPSignificanceManager();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	void RegisterCharacter(ANNP_BitFryTestDemoCharacter *character);
+	void UnregisterCharacter(ANNP_BitFryTestDemoCharacter *character);
+
+	/** Visible characters closer than this tick every frame. */
+	UPROPERTY(EditAnywhere, Category = Significance)
+	float NearDistance;
+
+	/** Visible characters closer than this tick every 2nd frame. */
+	UPROPERTY(EditAnywhere, Category = Significance)
+	float MidDistance;
+
+	/** Visible characters closer than this tick every 4th frame.  Anything further is dormant. */
+	UPROPERTY(EditAnywhere, Category = Significance)
+	float FarDistance;
+
+	/** Every character is rescored once over this many frames. */
+	UPROPERTY(EditAnywhere, Category = Significance)
+	int32 FramesPerSweep;
+
+	/** Spawn a crowd and compare game-thread time with significance off and on. */
+	void StartBenchmark(int32 numPawns, int32 numFrames);
+
+	/** Log how many characters are in each bucket. */
+	void LogReport() const;
+
+	/** Spawn AI characters of the default pawn class in a grid around the player. */
+	void SpawnCrowd(int32 numPawns);
+
+protected:
+	struct FSignificanceEntry
+	{
+		ANNP_BitFryTestDemoCharacter *Character;
+		int32 Bucket;
+		float TickInterval;
+		bool bLocal;
+	};
+
+	TArray<FSignificanceEntry> Entries;
+	int32 NextEntry;
+	bool bEnabled;
+
+	void UpdateEntry(FSignificanceEntry& entry, const FVector& viewLocation, float frameSeconds, float minInterval);
+	void SetEnabled(bool enabled);
+	void UpdateBenchmark(float DeltaSeconds);
+
+	NNPBenchmarkPhases BenchmarkPhase;
+	int32 BenchmarkFrames;
+	int32 BenchmarkFramesLeft;
+	double BenchmarkGameThreadMs;
+	double BenchmarkAnimGatherMs;
+	double BenchmarkAnimWorkerMs;
+	double BenchmarkOffMs;
+
+	void LogBenchmarkRun(const TCHAR *name) const;
+};
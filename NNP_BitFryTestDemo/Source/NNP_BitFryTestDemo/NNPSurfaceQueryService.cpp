@@ -0,0 +1,400 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NNPSurfaceQueryService.h"
+#include "NNP_BitFryTestDemo.h"
+#include "NNP_BitFryTestDemoCharacter.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "RenderCore.h"
+
+#define BENCHMARK_WARMUP_FRAMES 60
+// Ground steeper than this counts as a ramp even when it isn't the ramp mesh.  cos(10 degrees).
+#define RAMP_MIN_NORMAL_Z 0.985f
+
+static const TCHAR *QueryModeNames[MAX_QUERY_MODES] = { TEXT("async cached"), TEXT("async every frame"), TEXT("synchronous") };
+
+static NNPSurfaces SurfaceShape(const FHitResult& hit)
+{
+	static const FName rampMesh(TEXT("Ramp_StaticMesh"));
+	static const FName stairsMesh(TEXT("Linear_Stair_StaticMesh"));
+	UStaticMeshComponent *component = Cast<UStaticMeshComponent>(hit.GetComponent());
+
+	if(component && component->GetStaticMesh())
+	{
+		FName meshName = component->GetStaticMesh()->GetFName();
+
+		if(meshName == stairsMesh)
+			return Stairs_Surface;
+		if(meshName == rampMesh)
+			return Ramp_Surface;
+	}
+
+	return hit.ImpactNormal.Z < RAMP_MIN_NORMAL_Z ? Ramp_Surface : Flat_Surface;
+}
+
+static const FHitResult* FirstBlockingHit(const TArray<FHitResult>& hits)
+{
+	for(const FHitResult& hit : hits)
+	{
+		if(hit.bBlockingHit)
+			return &hit;
+	}
+
+	return nullptr;
+}
+
+ANNPSurfaceQueryService::ANNPSurfaceQueryService()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PrePhysics;
+
+	RequeryDistance = 50.0f;
+	RequeryYaw = 30.0f;
+	GroundProbeDistance = 100.0f;
+	ProximityDistance = 150.0f;
+	MaxQueriesPerFrame = 256;
+
+	NextEntry = 0;
+	Mode = AsyncCached_QueryMode;
+	TracesThisFrame = 0;
+
+	BenchmarkMode = INDEX_NONE;
+	bBenchmarkMeasuring = false;
+	BenchmarkFrames = 0;
+	BenchmarkFramesLeft = 0;
+	BenchmarkGameThreadMs = 0.0;
+	BenchmarkServiceMs = 0.0;
+	BenchmarkTraces = 0;
+}
+
+void ANNPSurfaceQueryService::RegisterCharacter(ANNP_BitFryTestDemoCharacter *character)
+{
+	AddEntry(character, false);
+}
+
+void ANNPSurfaceQueryService::AddEntry(ANNP_BitFryTestDemoCharacter *character, bool benchmarkOnly)
+{
+	FSurfaceQueryEntry entry;
+
+	for(FSurfaceQueryEntry& existing : Entries)
+	{
+		if(existing.Character == character)
+		{
+			// A character that registers itself mid-benchmark stays when it ends.
+			existing.bBenchmarkOnly &= benchmarkOnly;
+			return;
+		}
+	}
+
+	entry.Character = character;
+	entry.QueryLocation = FVector::ZeroVector;
+	entry.QueryYaw = 0.0f;
+	entry.bHasResult = false;
+	entry.bBenchmarkOnly = benchmarkOnly;
+	Entries.Add(entry);
+}
+
+void ANNPSurfaceQueryService::UnregisterCharacter(ANNP_BitFryTestDemoCharacter *character)
+{
+	int32 i;
+
+	// Any traces still in flight for it are simply never collected.
+	for(i = 0; i < Entries.Num(); i++)
+	{
+		if(Entries[i].Character == character)
+		{
+			Entries.RemoveAtSwap(i);
+			break;
+		}
+	}
+}
+
+void ANNPSurfaceQueryService::Tick(float DeltaSeconds)
+{
+	uint32 startCycles = FPlatformTime::Cycles();
+
+	Super::Tick(DeltaSeconds);
+
+	TracesThisFrame = 0;
+
+	if(Mode == Sync_QueryMode)
+		QuerySync();
+	else
+	{
+		GatherResults();
+		SubmitQueries();
+	}
+
+	if(BenchmarkMode != INDEX_NONE)
+		UpdateBenchmark(FPlatformTime::ToMilliseconds(FPlatformTime::Cycles() - startCycles));
+}
+
+bool ANNPSurfaceQueryService::NeedsQuery(const FSurfaceQueryEntry& entry) const
+{
+	ANNP_BitFryTestDemoCharacter *character = entry.Character;
+
+	// Still waiting on the last one, or dormant and not using the result anyway.
+	if(entry.GroundTrace.IsValid() || !character->IsActorTickEnabled())
+		return false;
+
+	if(!entry.bHasResult || Mode == AsyncEveryFrame_QueryMode)
+		return true;
+
+	return FVector::DistSquared(character->GetActorLocation(), entry.QueryLocation) > RequeryDistance * RequeryDistance ||
+		FMath::Abs(FRotator::NormalizeAxis(character->GetActorRotation().Yaw - entry.QueryYaw)) > RequeryYaw;
+}
+
+void ANNPSurfaceQueryService::GetTraces(ANNP_BitFryTestDemoCharacter *character, FVector& groundStart, FVector& groundEnd, FVector& proximityStart, FVector& proximityEnd) const
+{
+	UCapsuleComponent *capsule = character->GetCapsuleComponent();
+	FVector location = character->GetActorLocation();
+	FVector forward = character->GetActorForwardVector();
+
+	groundStart = location;
+	groundEnd = location - FVector(0.0f, 0.0f, capsule->GetScaledCapsuleHalfHeight() + GroundProbeDistance);
+
+	proximityStart = location + forward * capsule->GetScaledCapsuleRadius();
+	proximityEnd = proximityStart + forward * ProximityDistance;
+}
+
+FNNPSurfaceInfo ANNPSurfaceQueryService::MakeSurfaceInfo(const FHitResult *ground, const FHitResult *proximity, float halfHeight) const
+{
+	FNNPSurfaceInfo info;
+
+	info.bValid = true;
+	info.bOnGround = ground != nullptr;
+	info.Shape = Flat_Surface;
+	info.SurfaceType = SurfaceType_Default;
+	info.PhysicalMaterial = nullptr;
+	info.Normal = FVector::UpVector;
+	info.GroundDistance = GroundProbeDistance;
+	info.ObstacleProximity = proximity ? 1.0f - proximity->Time : 0.0f;
+
+	if(ground)
+	{
+		info.Shape = SurfaceShape(*ground);
+		info.PhysicalMaterial = ground->PhysMaterial;
+		info.SurfaceType = UPhysicalMaterial::DetermineSurfaceType(ground->PhysMaterial.Get());
+		info.Normal = ground->ImpactNormal;
+		info.GroundDistance = FMath::Max(ground->Distance - halfHeight, 0.0f);
+	}
+
+	return info;
+}
+
+void ANNPSurfaceQueryService::GatherResults()
+{
+	UWorld *world = GetWorld();
+
+	for(FSurfaceQueryEntry& entry : Entries)
+	{
+		FTraceDatum ground;
+		FTraceDatum proximity;
+		bool haveGround;
+		bool haveProximity;
+
+		if(!entry.GroundTrace.IsValid())
+			continue;
+
+		haveGround = world->QueryTraceData(entry.GroundTrace, ground);
+		haveProximity = world->QueryTraceData(entry.ProximityTrace, proximity);
+		entry.GroundTrace = FTraceHandle();
+		entry.ProximityTrace = FTraceHandle();
+
+		// The batch was dropped, e.g. across a level change.  Ask again this frame.
+		if(!haveGround || !haveProximity)
+		{
+			entry.bHasResult = false;
+			continue;
+		}
+
+		entry.Character->ApplySurface(MakeSurfaceInfo(FirstBlockingHit(ground.OutHits), FirstBlockingHit(proximity.OutHits),
+			entry.Character->GetCapsuleComponent()->GetScaledCapsuleHalfHeight()));
+		entry.bHasResult = true;
+	}
+}
+
+void ANNPSurfaceQueryService::SubmitQueries()
+{
+	UWorld *world = GetWorld();
+	int32 maxQueries = BenchmarkMode != INDEX_NONE ? Entries.Num() : MaxQueriesPerFrame;
+	int32 submitted = 0;
+	int32 i;
+
+	// Round robin, so a capped frame doesn't always starve the same characters.  The
+	// benchmark lifts the cap, or async every frame would trace fewer than synchronous.
+	for(i = 0; i < Entries.Num() && submitted < maxQueries; i++)
+	{
+		if(NextEntry >= Entries.Num())
+			NextEntry = 0;
+
+		FSurfaceQueryEntry& entry = Entries[NextEntry++];
+		FVector groundStart, groundEnd, proximityStart, proximityEnd;
+
+		if(!NeedsQuery(entry))
+			continue;
+
+		GetTraces(entry.Character, groundStart, groundEnd, proximityStart, proximityEnd);
+
+		FCollisionQueryParams params(SCENE_QUERY_STAT(NNPSurfaceQuery), false, entry.Character);
+		params.bReturnPhysicalMaterial = true;
+		entry.GroundTrace = world->AsyncLineTraceByChannel(EAsyncTraceType::Single, groundStart, groundEnd, ECC_Visibility, params);
+
+		params.bReturnPhysicalMaterial = false;
+		entry.ProximityTrace = world->AsyncLineTraceByChannel(EAsyncTraceType::Single, proximityStart, proximityEnd, ECC_Visibility, params);
+
+		entry.QueryLocation = entry.Character->GetActorLocation();
+		entry.QueryYaw = entry.Character->GetActorRotation().Yaw;
+		submitted++;
+	}
+
+	TracesThisFrame += submitted * 2;
+}
+
+void ANNPSurfaceQueryService::QuerySync()
+{
+	UWorld *world = GetWorld();
+
+	for(FSurfaceQueryEntry& entry : Entries)
+	{
+		FVector groundStart, groundEnd, proximityStart, proximityEnd;
+		FHitResult ground;
+		FHitResult proximity;
+		bool hitGround;
+		bool hitProximity;
+
+		if(!entry.Character->IsActorTickEnabled())
+			continue;
+
+		GetTraces(entry.Character, groundStart, groundEnd, proximityStart, proximityEnd);
+
+		FCollisionQueryParams params(SCENE_QUERY_STAT(NNPSurfaceQuery), false, entry.Character);
+		params.bReturnPhysicalMaterial = true;
+		hitGround = world->LineTraceSingleByChannel(ground, groundStart, groundEnd, ECC_Visibility, params);
+
+		params.bReturnPhysicalMaterial = false;
+		hitProximity = world->LineTraceSingleByChannel(proximity, proximityStart, proximityEnd, ECC_Visibility, params);
+
+		entry.Character->ApplySurface(MakeSurfaceInfo(hitGround ? &ground : nullptr, hitProximity ? &proximity : nullptr,
+			entry.Character->GetCapsuleComponent()->GetScaledCapsuleHalfHeight()));
+		entry.bHasResult = true;
+		TracesThisFrame += 2;
+	}
+}
+
+void ANNPSurfaceQueryService::SetMode(NNPSurfaceQueryModes mode)
+{
+	Mode = mode;
+
+	// Forget what's in flight and cached so the new mode starts from scratch.
+	for(FSurfaceQueryEntry& entry : Entries)
+	{
+		entry.GroundTrace = FTraceHandle();
+		entry.ProximityTrace = FTraceHandle();
+		entry.bHasResult = false;
+	}
+}
+
+void ANNPSurfaceQueryService::LogReport() const
+{
+	int32 counts[MAX_SURFACES] = { 0 };
+	int32 inAir = 0;
+	int32 unknown = 0;
+
+	for(const FSurfaceQueryEntry& entry : Entries)
+	{
+		const FNNPSurfaceInfo& surface = entry.Character->GetSurface();
+
+		if(!surface.bValid)
+			unknown++;
+		else if(!surface.bOnGround)
+			inAir++;
+		else
+			counts[surface.Shape]++;
+	}
+
+	UE_LOG(LogNNP, Display, TEXT("Surfaces: %d characters, flat %d, ramp %d, stairs %d, in the air %d, not queried %d"),
+		Entries.Num(), counts[Flat_Surface], counts[Ramp_Surface], counts[Stairs_Surface], inAir, unknown);
+}
+
+void ANNPSurfaceQueryService::StartBenchmark(int32 numFrames)
+{
+	// In play only the local player is registered; a crowd gives the traces something to cost.
+	for(TActorIterator<ANNP_BitFryTestDemoCharacter> it(GetWorld()); it; ++it)
+		AddEntry(*it, true);
+
+	UE_LOG(LogNNP, Display, TEXT("Surface query benchmark: %d characters, %d frames per mode"), Entries.Num(), numFrames);
+
+	// Baseline first, ending on the mode used in play.
+	BenchmarkFrames = FMath::Max(numFrames, 1);
+	BenchmarkMode = Sync_QueryMode;
+	bBenchmarkMeasuring = false;
+	BenchmarkFramesLeft = BENCHMARK_WARMUP_FRAMES;
+	SetMode(Sync_QueryMode);
+}
+
+void ANNPSurfaceQueryService::UpdateBenchmark(double serviceMs)
+{
+	// GGameThreadTime is the previous frame's game thread time.  Async traces
+	// run on task threads; any wait for them at the start of a frame lands in it.
+	if(bBenchmarkMeasuring)
+	{
+		BenchmarkGameThreadMs += FPlatformTime::ToMilliseconds(GGameThreadTime);
+		BenchmarkServiceMs += serviceMs;
+		BenchmarkTraces += TracesThisFrame;
+	}
+
+	if(--BenchmarkFramesLeft > 0)
+		return;
+
+	if(!bBenchmarkMeasuring)
+	{
+		bBenchmarkMeasuring = true;
+		BenchmarkFramesLeft = BenchmarkFrames;
+		BenchmarkGameThreadMs = 0.0;
+		BenchmarkServiceMs = 0.0;
+		BenchmarkTraces = 0;
+		return;
+	}
+
+	// Two traces per character queried.  Service time only covers the game thread:
+	// synchronous traces run inside it, but async ones run on task threads and
+	// aren't timed at all, so there it is the cost of submitting and gathering.
+	UE_LOG(LogNNP, Display, TEXT("Surface query benchmark %s: %d characters, %.1f traces, service %.3f ms, game thread %.2f ms per frame"),
+		QueryModeNames[BenchmarkMode], Entries.Num(), (double)BenchmarkTraces / BenchmarkFrames, BenchmarkServiceMs / BenchmarkFrames, BenchmarkGameThreadMs / BenchmarkFrames);
+	UE_LOG(LogNNP, Display, TEXT("Surface query benchmark %s: service %.2f us per query, %.2f us per character per frame (%s)"),
+		QueryModeNames[BenchmarkMode], BenchmarkTraces > 0 ? BenchmarkServiceMs * 2000.0 / BenchmarkTraces : 0.0,
+		Entries.Num() > 0 ? BenchmarkServiceMs * 1000.0 / BenchmarkFrames / Entries.Num() : 0.0,
+		BenchmarkMode == Sync_QueryMode ? TEXT("traces on the game thread") : TEXT("game thread submit and gather only, traces on task threads not included"));
+
+	if(BenchmarkMode == AsyncCached_QueryMode)
+	{
+		EndBenchmark();
+		return;
+	}
+
+	BenchmarkMode--;
+	bBenchmarkMeasuring = false;
+	BenchmarkFramesLeft = BENCHMARK_WARMUP_FRAMES;
+	SetMode((NNPSurfaceQueryModes)BenchmarkMode);
+}
+
+void ANNPSurfaceQueryService::EndBenchmark()
+{
+	int32 i;
+
+	BenchmarkMode = INDEX_NONE;
+	LogReport();
+
+	// Stop querying the characters that only the benchmark wanted.
+	for(i = Entries.Num() - 1; i >= 0; i--)
+	{
+		if(Entries[i].bBenchmarkOnly)
+			Entries.RemoveAtSwap(i);
+	}
+
+	NextEntry = 0;
+}
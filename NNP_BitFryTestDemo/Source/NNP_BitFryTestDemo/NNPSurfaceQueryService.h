@@ -0,0 +1,140 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "WorldCollision.h"
+#include "NNPSurfaceQueryService.generated.h"
+
+class ANNP_BitFryTestDemoCharacter;
+
+typedef enum NNP_SURFACES
+{
+	Flat_Surface = 0,
+	Ramp_Surface,
+	Stairs_Surface,
+
+	MAX_SURFACES
+} NNPSurfaces;
+
+// How the service traces.  Only the first is used in play; the others are benchmark baselines.
+typedef enum NNP_SURFACE_QUERY_MODES
+{
+	AsyncCached_QueryMode = 0,
+	AsyncEveryFrame_QueryMode,
+	Sync_QueryMode,
+
+	MAX_QUERY_MODES
+} NNPSurfaceQueryModes;
+
+// What a character is standing on and walking towards.
+struct FNNPSurfaceInfo
+{
+	// False until the first query for the character completes.
+	bool bValid;
+	bool bOnGround;
+	NNPSurfaces Shape;
+	EPhysicalSurface SurfaceType;
+	TWeakObjectPtr<UPhysicalMaterial> PhysicalMaterial;
+	FVector Normal;
+	// From the bottom of the capsule to the ground.
+	float GroundDistance;
+	// 0 with nothing within ProximityDistance ahead, up to 1 when touching it.
+	float ObstacleProximity;
+};
+
+/**
+ * Ground and proximity traces for every registered character, submitted as one
+ * async batch per frame.  Results arrive the frame after they are submitted and
+ * are pushed to the character, which keeps them until it has moved or turned far
+ * enough to need a new query.  Characters that aren't ticking aren't queried.
+ * Only characters that use the result register: in play, that's the local player.
+ */
+UCLASS()
+class NNP_BITFRYTESTDEMO_API ANNPSurfaceQueryService : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ANNPSurfaceQueryService();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	void RegisterCharacter(ANNP_BitFryTestDemoCharacter *character);
+	void UnregisterCharacter(ANNP_BitFryTestDemoCharacter *character);
+
+	/** A character is queried again once it moves this far from where it was last queried. */
+	UPROPERTY(EditAnywhere, Category = SurfaceQueries)
+	float RequeryDistance;
+
+	/** ...or turns this many degrees, since the proximity trace points where it faces. */
+	UPROPERTY(EditAnywhere, Category = SurfaceQueries)
+	float RequeryYaw;
+
+	/** How far below the capsule the ground trace reaches. */
+	UPROPERTY(EditAnywhere, Category = SurfaceQueries)
+	float GroundProbeDistance;
+
+	/** How far ahead of the capsule the proximity trace reaches. */
+	UPROPERTY(EditAnywhere, Category = SurfaceQueries)
+	float ProximityDistance;
+
+	/** Most characters queried in one frame in play.  The rest wait for the following frames. */
+	UPROPERTY(EditAnywhere, Category = SurfaceQueries)
+	int32 MaxQueriesPerFrame;
+
+	/**
+	 * Measure trace cost for every character in the world: synchronous, async every frame, and
+	 * async cached.  Characters that don't use the result are only queried while it runs, and
+	 * MaxQueriesPerFrame is lifted so every mode queries everyone who needs it.  Service time
+	 * is game thread time only, so for the async modes it leaves out the traces themselves.
+	 */
+	void StartBenchmark(int32 numFrames);
+
+	/** Log how many characters are on each kind of surface. */
+	void LogReport() const;
+
+protected:
+	struct FSurfaceQueryEntry
+	{
+		ANNP_BitFryTestDemoCharacter *Character;
+		FVector QueryLocation;
+		float QueryYaw;
+		FTraceHandle GroundTrace;
+		FTraceHandle ProximityTrace;
+		bool bHasResult;
+		// Registered by the benchmark rather than the character, and dropped when it ends.
+		bool bBenchmarkOnly;
+	};
+
+	TArray<FSurfaceQueryEntry> Entries;
+	int32 NextEntry;
+	NNPSurfaceQueryModes Mode;
+	int32 TracesThisFrame;
+
+	void AddEntry(ANNP_BitFryTestDemoCharacter *character, bool benchmarkOnly);
+	bool NeedsQuery(const FSurfaceQueryEntry& entry) const;
+	void GetTraces(ANNP_BitFryTestDemoCharacter *character, FVector& groundStart, FVector& groundEnd, FVector& proximityStart, FVector& proximityEnd) const;
+	FNNPSurfaceInfo MakeSurfaceInfo(const FHitResult *ground, const FHitResult *proximity, float halfHeight) const;
+	void SetMode(NNPSurfaceQueryModes mode);
+
+	/** Pick up last frame's batch and hand the results to the characters. */
+	void GatherResults();
+	/** Queue this frame's batch. */
+	void SubmitQueries();
+	/** Benchmark baseline: trace everyone on the spot. */
+	void QuerySync();
+
+	int32 BenchmarkMode;
+	bool bBenchmarkMeasuring;
+	int32 BenchmarkFrames;
+	int32 BenchmarkFramesLeft;
+	double BenchmarkGameThreadMs;
+	double BenchmarkServiceMs;
+	int64 BenchmarkTraces;
+
+	void UpdateBenchmark(double serviceMs);
+	void EndBenchmark();
+};
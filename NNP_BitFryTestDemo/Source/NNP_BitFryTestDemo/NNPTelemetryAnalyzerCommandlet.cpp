@@ -0,0 +1,250 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NNPTelemetryAnalyzerCommandlet.h"
+#include "NNP_BitFryTestDemo.h"
+#include "NNPTelemetryRecorder.h"
+#include "NNPScalabilityGovernor.h"
+#include "Misc/FileHelper.h"
+
+#define HEATMAP_DEFAULT_CELL_SIZE 500.0f
+#define REPORT_MAX_ROWS 20
+
+// Value at the given percentile (0-1) of an already sorted array.
+static float Percentile(const TArray<float>& sorted, float percentile)
+{
+	int32 index;
+
+	if(sorted.Num() == 0)
+		return 0.0f;
+
+	index = FMath::Clamp(FMath::CeilToInt(percentile * sorted.Num()) - 1, 0, sorted.Num() - 1);
+	return sorted[index];
+}
+
+static void LogPercentileRow(const TCHAR *name, TArray<float>& values)
+{
+	float sum = 0.0f;
+
+	values.Sort();
+	for(float value : values)
+		sum += value;
+
+	UE_LOG(LogNNP, Display, TEXT("%-16s %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f"), name,
+		values.Num() ? values[0] : 0.0f,
+		values.Num() ? sum / values.Num() : 0.0f,
+		Percentile(values, 0.5f),
+		Percentile(values, 0.9f),
+		Percentile(values, 0.95f),
+		Percentile(values, 0.99f),
+		values.Num() ? values.Last() : 0.0f);
+}
+
+UNNPTelemetryAnalyzerCommandlet::UNNPTelemetryAnalyzerCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UNNPTelemetryAnalyzerCommandlet::Main(const FString& Params)
+{
+	FString path = FNNPTelemetryRecorder::GetDefaultPath();
+	FString csvPath;
+	float hitchMs = 0.0f;
+	float cellSize = HEATMAP_DEFAULT_CELL_SIZE;
+	TArray<uint8> data;
+
+	FParse::Value(*Params, TEXT("file="), path);
+	FParse::Value(*Params, TEXT("csv="), csvPath);
+	FParse::Value(*Params, TEXT("hitchms="), hitchMs);
+	FParse::Value(*Params, TEXT("cell="), cellSize);
+
+	if(!FFileHelper::LoadFileToArray(data, *path))
+	{
+		UE_LOG(LogNNP, Error, TEXT("Could not read telemetry file %s"), *path);
+		return 1;
+	}
+
+	if(data.Num() < (int32)sizeof(FNNPTelemetryHeader))
+	{
+		UE_LOG(LogNNP, Error, TEXT("%s is too small to be a telemetry file."), *path);
+		return 1;
+	}
+
+	const FNNPTelemetryHeader *header = (const FNNPTelemetryHeader*)data.GetData();
+	if(header->Magic != NNP_TELEMETRY_MAGIC || header->Version != NNP_TELEMETRY_VERSION || header->FrameSize != sizeof(FNNPTelemetryFrame))
+	{
+		UE_LOG(LogNNP, Error, TEXT("%s is not a version %d telemetry file."), *path, NNP_TELEMETRY_VERSION);
+		return 1;
+	}
+
+	if(data.Num() < (int32)(sizeof(FNNPTelemetryHeader) + (SIZE_T)header->Capacity * sizeof(FNNPTelemetryFrame)))
+	{
+		UE_LOG(LogNNP, Error, TEXT("%s is truncated."), *path);
+		return 1;
+	}
+
+	// Unroll the ring into recording order.
+	const FNNPTelemetryFrame *ring = (const FNNPTelemetryFrame*)(data.GetData() + sizeof(FNNPTelemetryHeader));
+	uint64 numFrames = FMath::Min<uint64>(header->FramesWritten, header->Capacity);
+	uint64 firstFrame = header->FramesWritten - numFrames;
+	TArray<FNNPTelemetryFrame> frames;
+
+	frames.Reserve((int32)numFrames);
+	for(uint64 i = 0; i < numFrames; i++)
+		frames.Add(ring[(firstFrame + i) % header->Capacity]);
+
+	if(frames.Num() == 0)
+	{
+		UE_LOG(LogNNP, Warning, TEXT("%s contains no frames."), *path);
+		return 0;
+	}
+
+	if(hitchMs <= 0.0f)
+		hitchMs = header->TargetFrameTimeMs * 2.0f;
+
+	double duration = frames.Last().Timestamp - frames[0].Timestamp;
+	UE_LOG(LogNNP, Display, TEXT("Telemetry: %s"), *path);
+	UE_LOG(LogNNP, Display, TEXT("Frames: %d of %llu recorded (ring capacity %u), %.1f seconds, target %.2f ms"),
+		frames.Num(), header->FramesWritten, header->Capacity, duration, header->TargetFrameTimeMs);
+
+	// Percentile table.
+	TArray<float> frameTimes;
+	TArray<float> gameThreadTimes;
+	TArray<float> inputEvents;
+	TArray<float> hapticsUpdates;
+	TArray<float> pawnCounts;
+
+	for(const FNNPTelemetryFrame& frame : frames)
+	{
+		frameTimes.Add(frame.FrameTimeMs);
+		gameThreadTimes.Add(frame.GameThreadTimeMs);
+		inputEvents.Add(frame.InputEvents);
+		hapticsUpdates.Add(frame.HapticsUpdates);
+		pawnCounts.Add(frame.PawnCount);
+	}
+
+	UE_LOG(LogNNP, Display, TEXT(""));
+	UE_LOG(LogNNP, Display, TEXT("%-16s %8s %8s %8s %8s %8s %8s %8s"), TEXT("Metric"), TEXT("Min"), TEXT("Mean"), TEXT("P50"), TEXT("P90"), TEXT("P95"), TEXT("P99"), TEXT("Max"));
+	LogPercentileRow(TEXT("FrameTime(ms)"), frameTimes);
+	LogPercentileRow(TEXT("GameThread(ms)"), gameThreadTimes);
+	LogPercentileRow(TEXT("InputEvents"), inputEvents);
+	LogPercentileRow(TEXT("HapticsUpdates"), hapticsUpdates);
+	LogPercentileRow(TEXT("Pawns"), pawnCounts);
+
+	// Hitch report: every frame over the threshold, grouped into runs of consecutive hitches.
+	TArray<int32> hitches;
+	int32 numRuns = 0;
+	float hitchTimeMs = 0.0f;
+
+	for(int32 i = 0; i < frames.Num(); i++)
+	{
+		if(frames[i].FrameTimeMs <= hitchMs)
+			continue;
+
+		if(hitches.Num() == 0 || hitches.Last() != i - 1)
+			numRuns++;
+
+		hitches.Add(i);
+		hitchTimeMs += frames[i].FrameTimeMs;
+	}
+
+	UE_LOG(LogNNP, Display, TEXT(""));
+	UE_LOG(LogNNP, Display, TEXT("Hitches over %.2f ms: %d frames (%.2f%%) in %d runs, %.1f ms total"),
+		hitchMs, hitches.Num(), 100.0f * hitches.Num() / frames.Num(), numRuns, hitchTimeMs);
+
+	if(hitches.Num())
+	{
+		hitches.Sort([&frames](int32 a, int32 b) { return frames[a].FrameTimeMs > frames[b].FrameTimeMs; });
+
+		UE_LOG(LogNNP, Display, TEXT("%10s %10s %10s %10s %6s %8s %6s %10s %10s"), TEXT("Frame"), TEXT("Time(s)"), TEXT("Frame(ms)"), TEXT("Game(ms)"), TEXT("Input"), TEXT("Haptics"), TEXT("Pawns"), TEXT("X"), TEXT("Y"));
+		for(int32 i = 0; i < FMath::Min(hitches.Num(), REPORT_MAX_ROWS); i++)
+		{
+			const FNNPTelemetryFrame& frame = frames[hitches[i]];
+			UE_LOG(LogNNP, Display, TEXT("%10llu %10.2f %10.2f %10.2f %6u %8u %6u %10.0f %10.0f"),
+				frame.FrameNumber, frame.Timestamp - frames[0].Timestamp, frame.FrameTimeMs, frame.GameThreadTimeMs,
+				frame.InputEvents, frame.HapticsUpdates, frame.PawnCount, frame.LocationX, frame.LocationY);
+		}
+	}
+
+	// Heatmap: time spent per 2D cell, and where the hitches happened.
+	TMap<FIntPoint, float> cellSeconds;
+	TMap<FIntPoint, int32> cellHitches;
+
+	cellSize = FMath::Max(cellSize, 1.0f);
+	for(const FNNPTelemetryFrame& frame : frames)
+	{
+		FIntPoint cell(FMath::FloorToInt(frame.LocationX / cellSize), FMath::FloorToInt(frame.LocationY / cellSize));
+		cellSeconds.FindOrAdd(cell) += frame.FrameTimeMs / 1000.0f;
+		if(frame.FrameTimeMs > hitchMs)
+			cellHitches.FindOrAdd(cell)++;
+	}
+
+	cellSeconds.ValueSort([](float a, float b) { return a > b; });
+
+	UE_LOG(LogNNP, Display, TEXT(""));
+	UE_LOG(LogNNP, Display, TEXT("Heatmap (%.0f unit cells, %d visited):"), cellSize, cellSeconds.Num());
+	UE_LOG(LogNNP, Display, TEXT("%10s %10s %10s %8s"), TEXT("X"), TEXT("Y"), TEXT("Seconds"), TEXT("Hitches"));
+
+	int32 row = 0;
+	for(const TPair<FIntPoint, float>& cell : cellSeconds)
+	{
+		if(row++ >= REPORT_MAX_ROWS)
+			break;
+
+		const int32 *numHitches = cellHitches.Find(cell.Key);
+		UE_LOG(LogNNP, Display, TEXT("%10.0f %10.0f %10.2f %8d"), cell.Key.X * cellSize, cell.Key.Y * cellSize, cell.Value, numHitches ? *numHitches : 0);
+	}
+
+	// Replay the trace through the scalability governor.  The recorded timings
+	// don't reflect the levels it picks, so this shows when it would react,
+	// not how well the new levels would have held the target.
+	if(FParse::Param(*Params, TEXT("governor")))
+	{
+		FNNPGovernorSettings settings;
+		settings.TargetFrameTimeMs = header->TargetFrameTimeMs;
+
+		FNNPScalabilityGovernor governor(settings);
+		TArray<int32> framesAtLevel;
+		int32 numChanges = 0;
+
+		framesAtLevel.SetNumZeroed(settings.MaxLevel + 1);
+
+		UE_LOG(LogNNP, Display, TEXT(""));
+		UE_LOG(LogNNP, Display, TEXT("Governor replay (target %.2f ms):"), settings.TargetFrameTimeMs);
+		for(const FNNPTelemetryFrame& frame : frames)
+		{
+			if(governor.Sample(frame.FrameTimeMs, frame.GameThreadTimeMs))
+			{
+				numChanges++;
+				UE_LOG(LogNNP, Display, TEXT("%10llu %10.2f  -> level %d"), frame.FrameNumber, frame.Timestamp - frames[0].Timestamp, governor.GetLevel());
+			}
+
+			framesAtLevel[governor.GetLevel()]++;
+		}
+
+		UE_LOG(LogNNP, Display, TEXT("%d level changes"), numChanges);
+		for(int32 level = 0; level < framesAtLevel.Num(); level++)
+			UE_LOG(LogNNP, Display, TEXT("Level %d: %.1f%% of frames"), level, 100.0f * framesAtLevel[level] / frames.Num());
+	}
+
+	if(!csvPath.IsEmpty())
+	{
+		FString csv = TEXT("Frame,Time,FrameTimeMs,GameThreadTimeMs,InputEvents,HapticsUpdates,Pawns,X,Y\n");
+		for(const FNNPTelemetryFrame& frame : frames)
+		{
+			csv += FString::Printf(TEXT("%llu,%f,%f,%f,%u,%u,%u,%f,%f\n"),
+				frame.FrameNumber, frame.Timestamp - frames[0].Timestamp, frame.FrameTimeMs, frame.GameThreadTimeMs,
+				frame.InputEvents, frame.HapticsUpdates, frame.PawnCount, frame.LocationX, frame.LocationY);
+		}
+
+		if(!FFileHelper::SaveStringToFile(csv, *csvPath))
+		{
+			UE_LOG(LogNNP, Error, TEXT("Could not write %s"), *csvPath);
+			return 1;
+		}
+	}
+
+	return 0;
+}
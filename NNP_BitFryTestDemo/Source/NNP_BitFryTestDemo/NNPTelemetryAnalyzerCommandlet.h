@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "NNPTelemetryAnalyzerCommandlet.generated.h"
+
+/**
+ * Offline analyzer for session telemetry recorded by FNNPTelemetryRecorder.
+ *
+ * Usage: <Editor>-Cmd NNP_BitFryTestDemo -run=NNPTelemetryAnalyzer [-file=<path>] [-hitchms=<ms>] [-cell=<units>] [-csv=<path>] [-governor]
+ *
+ * Prints percentile tables for frame and game-thread time, a hitch report and a
+ * location heatmap.  -csv writes the per-frame samples out in recording order.
+ * -governor replays the frame times through FNNPScalabilityGovernor and logs its decisions.
+ */
+UCLASS()
+class UNNPTelemetryAnalyzerCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UNNPTelemetryAnalyzerCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,130 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NNPTelemetryRecorder.h"
+#include "NNP_BitFryTestDemo.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+#define NNP_TELEMETRY_MMAP (PLATFORM_APPLE || PLATFORM_UNIX || PLATFORM_ANDROID)
+
+#if NNP_TELEMETRY_MMAP
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+FNNPTelemetryRecorder& FNNPTelemetryRecorder::Get()
+{
+	static FNNPTelemetryRecorder recorder;
+	return recorder;
+}
+
+FNNPTelemetryRecorder::FNNPTelemetryRecorder() : Header(nullptr), Frames(nullptr), MappedData(nullptr), MappedSize(0), FileHandle(-1)
+{
+
+}
+
+FNNPTelemetryRecorder::~FNNPTelemetryRecorder()
+{
+	Close();
+}
+
+FString FNNPTelemetryRecorder::GetDefaultPath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("Telemetry") / TEXT("Session.nnptm");
+}
+
+bool FNNPTelemetryRecorder::Open(const FString& path, uint32 capacity, float targetFrameTimeMs)
+{
+	Close();
+
+	if(capacity == 0)
+		return false;
+
+#if NNP_TELEMETRY_MMAP
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(path), true);
+	FString absolutePath = IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(*path);
+
+	MappedSize = sizeof(FNNPTelemetryHeader) + (SIZE_T)capacity * sizeof(FNNPTelemetryFrame);
+
+	FileHandle = open(TCHAR_TO_UTF8(*absolutePath), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if(FileHandle < 0)
+	{
+		UE_LOG(LogNNP, Warning, TEXT("Telemetry: failed to create %s"), *absolutePath);
+		return false;
+	}
+
+	if(ftruncate(FileHandle, (off_t)MappedSize) != 0)
+	{
+		UE_LOG(LogNNP, Warning, TEXT("Telemetry: failed to size %s to %llu bytes"), *absolutePath, (uint64)MappedSize);
+		Close();
+		return false;
+	}
+
+	MappedData = mmap(nullptr, MappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, FileHandle, 0);
+	if(MappedData == MAP_FAILED)
+	{
+		MappedData = nullptr;
+		UE_LOG(LogNNP, Warning, TEXT("Telemetry: failed to map %s"), *absolutePath);
+		Close();
+		return false;
+	}
+
+	// Touch every page now so the game thread never takes a first-write fault.
+	FMemory::Memzero(MappedData, MappedSize);
+
+	Header = (FNNPTelemetryHeader*)MappedData;
+	Frames = (FNNPTelemetryFrame*)((uint8*)MappedData + sizeof(FNNPTelemetryHeader));
+
+	Header->Magic = NNP_TELEMETRY_MAGIC;
+	Header->Version = NNP_TELEMETRY_VERSION;
+	Header->Capacity = capacity;
+	Header->FrameSize = sizeof(FNNPTelemetryFrame);
+	Header->FramesWritten = 0;
+	Header->TargetFrameTimeMs = targetFrameTimeMs;
+
+	UE_LOG(LogNNP, Log, TEXT("Telemetry: recording %u frames to %s"), capacity, *absolutePath);
+	return true;
+#else
+	UE_LOG(LogNNP, Warning, TEXT("Telemetry: memory-mapped recording is not supported on this platform."));
+	return false;
+#endif
+}
+
+void FNNPTelemetryRecorder::Close()
+{
+#if NNP_TELEMETRY_MMAP
+	if(MappedData)
+	{
+		msync(MappedData, MappedSize, MS_ASYNC);
+		munmap(MappedData, MappedSize);
+	}
+
+	if(FileHandle >= 0)
+		close(FileHandle);
+#endif
+
+	Header = nullptr;
+	Frames = nullptr;
+	MappedData = nullptr;
+	MappedSize = 0;
+	FileHandle = -1;
+}
+
+bool FNNPTelemetryRecorder::IsRecording() const
+{
+	return Header != nullptr;
+}
+
+void FNNPTelemetryRecorder::RecordFrame(const FNNPTelemetryFrame& frame)
+{
+	if(!Header)
+		return;
+
+	Frames[Header->FramesWritten % Header->Capacity] = frame;
+
+	// Publish the frame only after it has been written, so a reader mapping the
+	// file mid-session never sees a counted frame with stale contents.
+	FPlatformMisc::MemoryBarrier();
+	Header->FramesWritten++;
+}
@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#define NNP_TELEMETRY_MAGIC 0x4D54504E // 'NPTM'
+#define NNP_TELEMETRY_VERSION 1
+#define NNP_TELEMETRY_DEFAULT_CAPACITY 65536 // ~18 minutes at 60 fps
+
+// One sample per game frame.  Plain old data so it can be copied straight
+// into the mapped file and read back by the analyzer without any parsing.
+struct FNNPTelemetryFrame
+{
+	uint64 FrameNumber;
+	double Timestamp;
+	float FrameTimeMs;
+	float GameThreadTimeMs;
+	uint16 InputEvents;
+	uint16 HapticsUpdates;
+	uint16 PawnCount;
+	uint16 Reserved;
+	float LocationX;
+	float LocationY;
+};
+
+// Lives at the start of the ring file.  FramesWritten keeps counting past
+// Capacity, so the oldest frame is at (FramesWritten % Capacity) once the
+// ring has wrapped.
+struct FNNPTelemetryHeader
+{
+	uint32 Magic;
+	uint32 Version;
+	uint32 Capacity;
+	uint32 FrameSize;
+	uint64 FramesWritten;
+	float TargetFrameTimeMs;
+	uint32 Reserved;
+};
+
+/**
+ * Records per-frame session telemetry into a fixed-size memory-mapped ring file.
+ * The file is sized and touched once in Open(), so RecordFrame() is just a copy
+ * into mapped memory: no allocation and no blocking I/O on the game thread.
+ * The OS writes the dirty pages back on its own schedule.
+ */
+class NNP_BITFRYTESTDEMO_API FNNPTelemetryRecorder
+{
+public:
+	static FNNPTelemetryRecorder& Get();
+
+	// Map a ring file able to hold the given number of frames.  Returns false
+	// if the file could not be created or mapped, or on unsupported platforms.
+	bool Open(const FString& path, uint32 capacity = NNP_TELEMETRY_DEFAULT_CAPACITY, float targetFrameTimeMs = 1000.0f / 60.0f);
+	void Close();
+
+	bool IsRecording() const;
+
+	// Copy a frame into the ring.  Game thread only.
+	void RecordFrame(const FNNPTelemetryFrame& frame);
+
+	// Default location of the ring file under Saved/Telemetry.
+	static FString GetDefaultPath();
+
+private:
+	FNNPTelemetryRecorder();
+	~FNNPTelemetryRecorder();
+
+	FNNPTelemetryHeader *Header;
+	FNNPTelemetryFrame *Frames;
+	void *MappedData;
+	SIZE_T MappedSize;
+	int FileHandle;
+};
@@ -8,8 +8,14 @@ public class NNP_BitFryTestDemo : ModuleRules
 	{
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
-		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "HeadMountedDisplay" });
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "HeadMountedDisplay", "RenderCore", "AssetRegistry", "EngineSettings", "PhysicsCore", "NNPCore" });
 		
+		// The content footprint commandlet reads the packaging settings.
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.Add("UnrealEd");
+		}
+
 		PublicFrameworks.AddRange(new string[] {"GameController", "CoreHaptics"});
 	}
 }
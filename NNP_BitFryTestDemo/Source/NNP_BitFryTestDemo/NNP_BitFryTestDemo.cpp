@@ -2,6 +2,31 @@
 
 #include "NNP_BitFryTestDemo.h"
 #include "Modules/ModuleManager.h"
+#include "Misc/CommandLine.h"
+#include "NNPTelemetryRecorder.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, NNP_BitFryTestDemo, "NNP_BitFryTestDemo" );
- 
\ No newline at end of file
+DEFINE_LOG_CATEGORY(LogNNP);
+
+// NNP: Owns the session telemetry ring, so it outlives any one pawn and a
+// respawn keeps appending to the same recording.
+class FNNP_BitFryTestDemoModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+		// Session telemetry is opt-in with -NNPTelemetry or -NNPTelemetry=<path>.
+		FString telemetryPath;
+		if(!FParse::Value(FCommandLine::Get(), TEXT("NNPTelemetry="), telemetryPath) && FParse::Param(FCommandLine::Get(), TEXT("NNPTelemetry")))
+			telemetryPath = FNNPTelemetryRecorder::GetDefaultPath();
+
+		if(!telemetryPath.IsEmpty())
+			FNNPTelemetryRecorder::Get().Open(telemetryPath);
+	}
+
+	virtual void ShutdownModule() override
+	{
+		FNNPTelemetryRecorder::Get().Close();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FNNP_BitFryTestDemoModule, NNP_BitFryTestDemo, "NNP_BitFryTestDemo" );
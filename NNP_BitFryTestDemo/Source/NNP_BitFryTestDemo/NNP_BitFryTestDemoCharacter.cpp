@@ -3,15 +3,49 @@
 #include "NNP_BitFryTestDemoCharacter.h"
 #include "HeadMountedDisplayFunctionLibrary.h"
 #include "Camera/CameraComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Components/AudioComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/InputComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/Controller.h"
 #include "GameFramework/SpringArmComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Kismet/GameplayStatics.h"
+#include "Sound/SoundCue.h"
+#include "Sound/SoundNodeWavePlayer.h"
+#include "Sound/SoundWave.h"
+#include "NNPTelemetryRecorder.h"
+#include "NNPHapticEnvelopeAsset.h"
+#include "NNPSignificanceManager.h"
+#include "NNPSurfaceQueryService.h"
+#include "NNP_BitFryTestDemoGameMode.h"
+#include "RenderCore.h"
+#include "NNP_BitFryTestDemo.h"
 
 #define CAMERA_MOVE_SCALE 2.5f
 #define MIN_HAPTICS_DIST_SQ 10000.0f //100^2
 #define MAX_HAPTICS_DIST_SQ 100000000.0f // 10,000^2
+#define MIN_ARM_LENGTH 150.0f
+#define MAX_ARM_LENGTH 800.0f
+#define SWIPE_TURN_DEGREES 45.0f
+#define OBSTACLE_HAPTICS_INTENSITY 0.6f
+#define OBSTACLE_HAPTICS_SHARPNESS 0.2f
+
+// NNP: Walking haptics for each kind of surface, at full walking speed.
+struct FNNPSurfaceHaptics
+{
+	float Intensity;
+	float Sharpness;
+};
+
+static const FNNPSurfaceHaptics SurfaceHaptics[MAX_SURFACES] =
+{
+	{ 0.15f, 0.3f },	// Flat_Surface
+	{ 0.25f, 0.45f },	// Ramp_Surface
+	{ 0.45f, 0.85f },	// Stairs_Surface
+};
 
 void HandleButtonCallbacks(NNPButtons button, void *object, bool pressed)
 {
@@ -27,6 +61,8 @@ void HandleButtonCallbacks(NNPButtons button, void *object, bool pressed)
 //////////////////////////////////////////////////////////////////////////
 // ANNP_BitFryTestDemoCharacter
 
+int32 ANNP_BitFryTestDemoCharacter::NumActiveCharacters = 0;
+
 ANNP_BitFryTestDemoCharacter::ANNP_BitFryTestDemoCharacter()
 {
 	// Set size for collision capsule
@@ -61,8 +97,132 @@ ANNP_BitFryTestDemoCharacter::ANNP_BitFryTestDemoCharacter()
 	// Note: The skeletal mesh and anim blueprint references on the Mesh component (inherited from Character) 
 	// are set in the derived blueprint asset named MyCharacter (to avoid direct content references in C++)
 	
+	// NNP: Let distant and small-on-screen characters skip anim updates and interpolate between them.
+	GetMesh()->bEnableUpdateRateOptimizations = true;
+	GetMesh()->OnAnimUpdateRateParamsCreated.BindUObject(this, &ANNP_BitFryTestDemoCharacter::ConfigureAnimUpdateRate);
+	
 	// NNP: Initialize my demo controller.
 	NNPController = CreateDefaultSubobject<ANNPPlayerController>(TEXT("NNPPlayerController"));
+	
+	bUseFixedTimestep = false;
+	FixedTimestepRate = 60.0f;
+	MaxFixedSubSteps = 4;
+	PendingMoveForward = 0.0f;
+	PendingMoveRight = 0.0f;
+	PendingTurnRate = 0.0f;
+	PendingLookUpRate = 0.0f;
+	PreviousStepLocation = FVector::ZeroVector;
+	MeshBaseLocation = FVector::ZeroVector;
+	
+	bStopJumpingNextTick = false;
+	DefaultArmLength = CameraBoom->TargetArmLength;
+	
+	Surface.bValid = false;
+	Surface.bOnGround = false;
+	Surface.Shape = Flat_Surface;
+	Surface.SurfaceType = SurfaceType_Default;
+	Surface.Normal = FVector::UpVector;
+	Surface.GroundDistance = 0.0f;
+	Surface.ObstacleProximity = 0.0f;
+}
+
+void ANNP_BitFryTestDemoCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+	
+	NumActiveCharacters++;
+	
+	ANNP_BitFryTestDemoGameMode *gameMode = GetWorld()->GetAuthGameMode<ANNP_BitFryTestDemoGameMode>();
+	if(gameMode && gameMode->GetSignificanceManager())
+		gameMode->GetSignificanceManager()->RegisterCharacter(this);
+	
+	// NNP: The first possession can come before the game mode has begun play and made the service.
+	UpdateSurfaceQueryRegistration();
+	
+	// NNP: In fixed timestep mode the character steps its own movement from Tick.
+	if(bUseFixedTimestep)
+	{
+		GetCharacterMovement()->SetComponentTickEnabled(false);
+		FixedStepper.SetRate(FixedTimestepRate, MaxFixedSubSteps);
+		PreviousStepLocation = GetActorLocation();
+		MeshBaseLocation = GetMesh()->GetRelativeLocation();
+	}
+}
+
+void ANNP_BitFryTestDemoCharacter::Restart()
+{
+	Super::Restart();
+	
+	UpdateSurfaceQueryRegistration();
+}
+
+void ANNP_BitFryTestDemoCharacter::UnPossessed()
+{
+	Super::UnPossessed();
+	
+	UpdateSurfaceQueryRegistration();
+}
+
+void ANNP_BitFryTestDemoCharacter::UpdateSurfaceQueryRegistration()
+{
+	ANNP_BitFryTestDemoGameMode *gameMode = GetWorld()->GetAuthGameMode<ANNP_BitFryTestDemoGameMode>();
+	
+	if(!gameMode || !gameMode->GetSurfaceQueryService())
+		return;
+	
+	// NNP: Possession changes who's the local player, so this runs on both sides of it.
+	if(IsLocalPlayer())
+		gameMode->GetSurfaceQueryService()->RegisterCharacter(this);
+	else
+		gameMode->GetSurfaceQueryService()->UnregisterCharacter(this);
+}
+
+void ANNP_BitFryTestDemoCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	NumActiveCharacters--;
+	
+	ANNP_BitFryTestDemoGameMode *gameMode = GetWorld()->GetAuthGameMode<ANNP_BitFryTestDemoGameMode>();
+	if(gameMode && gameMode->GetSignificanceManager())
+		gameMode->GetSignificanceManager()->UnregisterCharacter(this);
+	if(gameMode && gameMode->GetSurfaceQueryService())
+		gameMode->GetSurfaceQueryService()->UnregisterCharacter(this);
+	
+	// NNP: Report how long gestures took to reach the character this session.
+	for(int32 i = 0; i < MAX_GESTURES; i++)
+	{
+		const GestureLatency& latency = Gestures.GetLatency((NNPGestures)i);
+		if(latency.Count)
+			UE_LOG(LogNNP, Log, TEXT("Gesture %d: %d recognized, latency avg %.1f ms, max %.1f ms"), i, latency.Count, latency.TotalSeconds * 1000.0 / latency.Count, latency.MaxSeconds * 1000.0);
+	}
+	
+	UnhookAudioComponents();
+	
+	// NNP: Don't leave the device rumbling at whatever the last envelope frame was.
+	if(HapticStreamer.IsPlaying())
+	{
+		HapticStreamer.StopAll();
+		HapticStreamer.Update(0.0f, NNPController);
+	}
+	
+	Super::EndPlay(EndPlayReason);
+}
+
+void ANNP_BitFryTestDemoCharacter::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+	
+	ProcessGestures();
+	
+	if(bUseFixedTimestep)
+		StepFixedTimestep(DeltaSeconds);
+	
+	// NNP: Surface rumble and any playing envelopes, sent only when they change.
+	if(IsLocalPlayer())
+		HapticStreamer.Update(DeltaSeconds, NNPController);
+	
+	// NNP: The module keeps the ring open for the whole session; the player's pawn fills it.
+	if(IsLocalPlayer() && FNNPTelemetryRecorder::Get().IsRecording())
+		RecordTelemetry(DeltaSeconds);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -75,6 +235,9 @@ void ANNP_BitFryTestDemoCharacter::SetupPlayerInputComponent(class UInputCompone
 	
 	if(NNPController)
 		NNPController->InitializeHardwareController(Controller->GetControlRotation());
+	
+	LoadHapticEnvelopes();
+	HookAudioComponents();
 		
 	if(NNPController->IsInitialized())
 	{
@@ -103,6 +266,7 @@ void ANNP_BitFryTestDemoCharacter::SetupPlayerInputComponent(class UInputCompone
 	// handle touch devices
 	PlayerInputComponent->BindTouch(IE_Pressed, this, &ANNP_BitFryTestDemoCharacter::TouchStarted);
 	PlayerInputComponent->BindTouch(IE_Released, this, &ANNP_BitFryTestDemoCharacter::TouchStopped);
+	PlayerInputComponent->BindTouch(IE_Repeat, this, &ANNP_BitFryTestDemoCharacter::TouchMoved);
 
 	// VR headset functionality
 	PlayerInputComponent->BindAction("ResetVR", IE_Pressed, this, &ANNP_BitFryTestDemoCharacter::OnResetVR);
@@ -131,25 +295,262 @@ void ANNP_BitFryTestDemoCharacter::DoNothing()
 
 void ANNP_BitFryTestDemoCharacter::UpdateHaptics()
 {
-	float intensity = 0.3f;
+	float intensity = 0.0f;
 	float sharpness = 0.5f;
-	FVector origin = FVector(0.0f, 0.0f, 0.0f);
-	FVector worldPosition = GetActorLocation();
+	float speed;
 	
-	float distSq = FVector::DistSquared2D(origin, worldPosition);
+	// NNP: Haptics only ever play on the local player's device.
+	if(!IsLocalPlayer())
+		return;
 	
-	intensity = 1.0f - MIN(1.0f, (distSq - MIN_HAPTICS_DIST_SQ) / MAX_HAPTICS_DIST_SQ);
-/*
-	if(GEngine)
+	// NNP: A rumble under the feet that depends on what they're on, scaled by walking speed,
+	// plus a push back when walking into something.
+	if(Surface.bValid && Surface.bOnGround)
 	{
-		GEngine->AddOnScreenDebugMessage(-1, 15.0f, FColor::Yellow, FString::Printf(TEXT("Pos: (%f, %f)"), worldPosition.X, worldPosition.Y));
-		GEngine->AddOnScreenDebugMessage(-1, 15.0f, FColor::Yellow, FString::Printf(TEXT("DistSq: %f"), distSq));
-		GEngine->AddOnScreenDebugMessage(-1, 15.0f, FColor::Yellow, FString::Printf(TEXT("intensity: %f"), intensity));
+		speed = FMath::Clamp(GetVelocity().Size2D() / FMath::Max(GetCharacterMovement()->MaxWalkSpeed, 1.0f), 0.0f, 1.0f);
+		intensity = SurfaceHaptics[Surface.Shape].Intensity * speed;
+		sharpness = SurfaceHaptics[Surface.Shape].Sharpness;
+		
+		if(Surface.ObstacleProximity * speed * OBSTACLE_HAPTICS_INTENSITY > intensity)
+		{
+			intensity = Surface.ObstacleProximity * speed * OBSTACLE_HAPTICS_INTENSITY;
+			sharpness = OBSTACLE_HAPTICS_SHARPNESS;
+		}
 	}
-*/
 	
-	//if(NNPController)
-	//	NNPController->UpdateHaptics(intensity, sharpness);
+	HapticStreamer.SetBaseLevel(intensity, sharpness);
+}
+
+void ANNP_BitFryTestDemoCharacter::ApplySurface(const FNNPSurfaceInfo& surface)
+{
+	Surface = surface;
+}
+
+const FNNPSurfaceInfo& ANNP_BitFryTestDemoCharacter::GetSurface() const
+{
+	return Surface;
+}
+
+void ANNP_BitFryTestDemoCharacter::LoadHapticEnvelopes()
+{
+	LoadedHapticEnvelopes.Reset();
+	
+	// A few hundred bytes each, so loading them up front costs nothing noticeable.
+	for(const FSoftObjectPath& path : HapticEnvelopes)
+	{
+		UNNPHapticEnvelopeAsset *envelope = Cast<UNNPHapticEnvelopeAsset>(path.TryLoad());
+		
+		if(envelope)
+			LoadedHapticEnvelopes.Add(envelope);
+		else
+			UE_LOG(LogNNP, Warning, TEXT("Could not load haptic envelope %s"), *path.ToString());
+	}
+}
+
+const UNNPHapticEnvelopeAsset* ANNP_BitFryTestDemoCharacter::FindHapticEnvelope(USoundBase *sound) const
+{
+	USoundCue *cue = Cast<USoundCue>(sound);
+	
+	if(cue)
+	{
+		TArray<USoundNodeWavePlayer*> players;
+		
+		// Which wave a cue picks isn't known up front; take the first one with an envelope.
+		cue->RecursiveFindNode<USoundNodeWavePlayer>(cue->FirstNode, players);
+		for(USoundNodeWavePlayer *player : players)
+		{
+			const UNNPHapticEnvelopeAsset *envelope = FindHapticEnvelope(player->GetSoundWave());
+			if(envelope)
+				return envelope;
+		}
+		
+		return nullptr;
+	}
+	
+	for(const UNNPHapticEnvelopeAsset *envelope : LoadedHapticEnvelopes)
+	{
+		if(sound && envelope->Sound.ToSoftObjectPath() == FSoftObjectPath(sound))
+			return envelope;
+	}
+	
+	return nullptr;
+}
+
+void ANNP_BitFryTestDemoCharacter::PlaySoundWithHaptics(USoundBase *Sound, FVector Location)
+{
+	const UNNPHapticEnvelopeAsset *envelope;
+	
+	if(!Sound)
+		return;
+	
+	UGameplayStatics::PlaySoundAtLocation(this, Sound, Location);
+	
+	// NNP: Haptics only ever play on the local player's device.
+	if(!IsLocalPlayer())
+		return;
+	
+	envelope = FindHapticEnvelope(Sound);
+	if(envelope)
+		PlayHapticEnvelope(envelope, Location);
+}
+
+void ANNP_BitFryTestDemoCharacter::PlayHapticEnvelope(const UNNPHapticEnvelopeAsset *envelope, FVector location)
+{
+	float distSq;
+	
+	// Same falloff as the old distance-based haptics.
+	distSq = FVector::DistSquared2D(GetActorLocation(), location);
+	HapticStreamer.Play(&envelope->Envelope, 1.0f - FMath::Clamp((distSq - MIN_HAPTICS_DIST_SQ) / MAX_HAPTICS_DIST_SQ, 0.0f, 1.0f));
+}
+
+void ANNP_BitFryTestDemoCharacter::HookAudioComponents()
+{
+	UnhookAudioComponents();
+	
+	// NNP: Nothing to stream without envelopes, and only the local player's device plays them.
+	if(LoadedHapticEnvelopes.Num() == 0 || !IsLocalPlayer())
+		return;
+	
+	for(TActorIterator<AActor> it(GetWorld()); it; ++it)
+		HookActorAudio(*it);
+	
+	ActorSpawnedHandle = GetWorld()->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &ANNP_BitFryTestDemoCharacter::HookActorAudio));
+}
+
+void ANNP_BitFryTestDemoCharacter::HookActorAudio(AActor *actor)
+{
+	TInlineComponentArray<UAudioComponent*> components(actor);
+	
+	for(UAudioComponent *component : components)
+	{
+		component->OnAudioPlayStateChangedNative.AddUObject(this, &ANNP_BitFryTestDemoCharacter::OnAudioPlayStateChanged);
+		HookedAudioComponents.Add(component);
+		
+		// Auto-activated sounds may have started before the player was possessed.
+		if(component->IsPlaying())
+			OnAudioPlayStateChanged(component, EAudioComponentPlayState::Playing);
+	}
+}
+
+void ANNP_BitFryTestDemoCharacter::UnhookAudioComponents()
+{
+	for(const TWeakObjectPtr<UAudioComponent>& component : HookedAudioComponents)
+	{
+		if(component.IsValid())
+			component->OnAudioPlayStateChangedNative.RemoveAll(this);
+	}
+	HookedAudioComponents.Reset();
+	
+	if(ActorSpawnedHandle.IsValid())
+	{
+		GetWorld()->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+		ActorSpawnedHandle.Reset();
+	}
+}
+
+void ANNP_BitFryTestDemoCharacter::OnAudioPlayStateChanged(const UAudioComponent *component, EAudioComponentPlayState state)
+{
+	const UNNPHapticEnvelopeAsset *envelope;
+	
+	// A looping sound plays once as far as this is concerned, so its envelope plays once too.
+	if(state != EAudioComponentPlayState::Playing || !IsLocalPlayer())
+		return;
+	
+	envelope = FindHapticEnvelope(component->Sound);
+	if(envelope)
+		PlayHapticEnvelope(envelope, component->GetComponentLocation());
+}
+
+bool ANNP_BitFryTestDemoCharacter::IsLocalPlayer() const
+{
+	return IsPlayerControlled() && IsLocallyControlled();
+}
+
+void ANNP_BitFryTestDemoCharacter::ApplySignificance(bool dormant, float tickInterval, bool alwaysTickPose)
+{
+	bool local = IsLocalPlayer();
+	
+	SetActorTickEnabled(!dormant);
+	SetActorTickInterval(tickInterval);
+	
+	// In fixed timestep mode movement is stepped from our own Tick instead.
+	GetCharacterMovement()->SetComponentTickEnabled(!dormant && !bUseFixedTimestep);
+	GetCharacterMovement()->SetComponentTickInterval(tickInterval);
+	
+	GetMesh()->SetComponentTickEnabled(!dormant);
+	// Characters that have been throttled also stop posing while they aren't rendered.
+	if(local || alwaysTickPose || tickInterval <= 0.0f)
+		GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+	else
+		GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+	
+	// NNP: Only the local player's camera is ever looked through.
+	CameraBoom->SetComponentTickEnabled(local);
+	FollowCamera->SetComponentTickEnabled(local);
+}
+
+void ANNP_BitFryTestDemoCharacter::ConfigureAnimUpdateRate(FAnimUpdateRateParameters *params)
+{
+	// Screen-size thresholds for updating every frame, every 2nd, 3rd and 4th.
+	static const float visibleDistanceFactors[] = { 0.4f, 0.2f, 0.1f };
+	
+	params->BaseVisibleDistanceFactorThesholds.Empty();
+	params->BaseVisibleDistanceFactorThesholds.Append(visibleDistanceFactors, UE_ARRAY_COUNT(visibleDistanceFactors));
+	params->bInterpolateSkippedFrames = true;
+	// Interpolate skipped frames up to every 4th; past that, just hold the pose.
+	params->MaxEvalRateForInterpolation = 4;
+	params->BaseNonRenderedUpdateRate = 8;
+}
+
+void ANNP_BitFryTestDemoCharacter::StepFixedTimestep(float DeltaSeconds)
+{
+	UCharacterMovementComponent *movement = GetCharacterMovement();
+	
+	// Each step turns by its own share of the frame's input before it moves,
+	// so the path walked doesn't depend on how many steps a frame holds.
+	FixedStepper.Advance(DeltaSeconds, [this, movement](float stepSeconds)
+	{
+		PreviousStepLocation = GetActorLocation();
+		
+		ApplyTurnAtRate(PendingTurnRate, stepSeconds);
+		ApplyLookUpAtRate(PendingLookUpRate, stepSeconds);
+		ApplyMoveForward(PendingMoveForward);
+		ApplyMoveRight(PendingMoveRight);
+		movement->TickComponent(stepSeconds, LEVELTICK_All, &movement->PrimaryComponentTick);
+	});
+	
+	// Draw the mesh and camera between the last two simulated positions so
+	// motion stays smooth when the frame rate and step rate don't line up.
+	FVector location = GetActorLocation();
+	FVector drawLocation = FMath::Lerp(PreviousStepLocation, location, FixedStepper.GetAlpha());
+	FVector localOffset = GetActorTransform().InverseTransformVectorNoScale(drawLocation - location);
+	
+	GetMesh()->SetRelativeLocation(MeshBaseLocation + localOffset);
+	CameraBoom->SetRelativeLocation(localOffset);
+}
+
+void ANNP_BitFryTestDemoCharacter::RecordTelemetry(float DeltaSeconds)
+{
+	FNNPTelemetryFrame frame;
+	int32 inputEvents = 0;
+	int32 hapticsUpdates = 0;
+	FVector worldPosition = GetActorLocation();
+	
+	if(NNPController)
+		NNPController->ConsumeFrameCounters(inputEvents, hapticsUpdates);
+	
+	frame.FrameNumber = GFrameCounter;
+	frame.Timestamp = FPlatformTime::Seconds();
+	frame.FrameTimeMs = DeltaSeconds * 1000.0f;
+	frame.GameThreadTimeMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	frame.InputEvents = (uint16)FMath::Min(inputEvents, (int32)MAX_uint16);
+	frame.HapticsUpdates = (uint16)FMath::Min(hapticsUpdates, (int32)MAX_uint16);
+	frame.PawnCount = (uint16)FMath::Clamp(NumActiveCharacters, 0, (int32)MAX_uint16);
+	frame.Reserved = 0;
+	frame.LocationX = worldPosition.X;
+	frame.LocationY = worldPosition.Y;
+	
+	FNNPTelemetryRecorder::Get().RecordFrame(frame);
 }
 
 void ANNP_BitFryTestDemoCharacter::OnResetVR()
@@ -165,18 +566,96 @@ void ANNP_BitFryTestDemoCharacter::OnResetVR()
 
 void ANNP_BitFryTestDemoCharacter::TouchStarted(ETouchIndex::Type FingerIndex, FVector Location)
 {
-		Jump();
+		if(NNPController)
+			NNPController->NotifyInputEvent();
+		
+		Gestures.AddSample(FingerIndex, true, FVector2D(Location), FPlatformTime::Seconds());
 }
 
 void ANNP_BitFryTestDemoCharacter::TouchStopped(ETouchIndex::Type FingerIndex, FVector Location)
 {
+		if(NNPController)
+			NNPController->NotifyInputEvent();
+		
+		Gestures.AddSample(FingerIndex, false, FVector2D(Location), FPlatformTime::Seconds());
+}
+
+void ANNP_BitFryTestDemoCharacter::TouchMoved(ETouchIndex::Type FingerIndex, FVector Location)
+{
+		if(NNPController)
+			NNPController->NotifyInputEvent();
+		
+		Gestures.AddSample(FingerIndex, true, FVector2D(Location), FPlatformTime::Seconds());
+}
+
+void ANNP_BitFryTestDemoCharacter::ProcessGestures()
+{
+	GestureEvent event;
+	double now = FPlatformTime::Seconds();
+	
+	// A tap jump is a press and release; let the movement component see the press first.
+	if(bStopJumpingNextTick)
+	{
 		StopJumping();
+		bStopJumpingNextTick = false;
+	}
+	
+	Gestures.Update(now);
+	
+	while(Gestures.PopEvent(event, now))
+		HandleGesture(event);
+}
+
+void ANNP_BitFryTestDemoCharacter::HandleGesture(const GestureEvent& event)
+{
+	switch(event.Type)
+	{
+		case Tap_Gesture:
+			Jump();
+			bStopJumpingNextTick = true;
+			break;
+			
+		case DoubleTap_Gesture:
+			// Both taps have already jumped; this only adds the camera reset.
+			CameraBoom->TargetArmLength = DefaultArmLength;
+			break;
+			
+		case Swipe_Gesture:
+			// Horizontal swipes snap the camera around the character.
+			if(Controller && FMath::Abs(event.Direction.X) > FMath::Abs(event.Direction.Y))
+			{
+				float yaw = event.Direction.X > 0.0f ? -SWIPE_TURN_DEGREES : SWIPE_TURN_DEGREES;
+				
+				if(NNPController && NNPController->IsInitialized())
+				{
+					NNPController->AddYawInput(yaw);
+					Controller->SetControlRotation(NNPController->GetOrientation());
+				}
+				else
+					Controller->SetControlRotation(Controller->GetControlRotation() + FRotator(0.0f, yaw, 0.0f));
+			}
+			break;
+			
+		case Pinch_Gesture:
+			// Spreading the fingers pulls the camera in.
+			CameraBoom->TargetArmLength = FMath::Clamp(CameraBoom->TargetArmLength / event.PinchScale, MIN_ARM_LENGTH, MAX_ARM_LENGTH);
+			break;
+			
+		default:
+			break;
+	}
 }
 
 void ANNP_BitFryTestDemoCharacter::TurnAtRate(float Rate)
 {
-	float deltaSeconds = GetWorld()->GetDeltaSeconds();
-	
+	if(bUseFixedTimestep)
+		PendingTurnRate = Rate;
+	else
+		ApplyTurnAtRate(Rate, GetWorld()->GetDeltaSeconds());
+}
+
+void ANNP_BitFryTestDemoCharacter::ApplyTurnAtRate(float Rate, float deltaSeconds)
+{
 	// calculate delta for this frame from the rate information
 	if(NNPController && NNPController->IsInitialized())
 	{
@@ -184,14 +663,22 @@ void ANNP_BitFryTestDemoCharacter::TurnAtRate(float Rate)
 		NNPController->AddYawInput(thumbstick.X * BaseTurnRate * deltaSeconds * CAMERA_MOVE_SCALE);
 		Controller->SetControlRotation(NNPController->GetOrientation());
 	}
+	else if(bUseFixedTimestep)
+		RotateControllerNow(Rate * BaseTurnRate * deltaSeconds, 0.0f, deltaSeconds);
 	else
 		AddControllerYawInput(Rate * BaseTurnRate * deltaSeconds);
 }
 
 void ANNP_BitFryTestDemoCharacter::LookUpAtRate(float Rate)
 {
-	float deltaSeconds = GetWorld()->GetDeltaSeconds();
-	
+	if(bUseFixedTimestep)
+		PendingLookUpRate = Rate;
+	else
+		ApplyLookUpAtRate(Rate, GetWorld()->GetDeltaSeconds());
+}
+
+void ANNP_BitFryTestDemoCharacter::ApplyLookUpAtRate(float Rate, float deltaSeconds)
+{
 	// calculate delta for this frame from the rate information
 	if(NNPController && NNPController->IsInitialized())
 	{
@@ -199,11 +686,50 @@ void ANNP_BitFryTestDemoCharacter::LookUpAtRate(float Rate)
 		NNPController->AddPitchInput(-thumbstick.Y * BaseLookUpRate * deltaSeconds * CAMERA_MOVE_SCALE);
 		Controller->SetControlRotation(NNPController->GetOrientation());
 	}
+	else if(bUseFixedTimestep)
+		RotateControllerNow(0.0f, Rate * BaseLookUpRate * deltaSeconds, deltaSeconds);
 	else
 		AddControllerPitchInput(Rate * BaseLookUpRate * deltaSeconds);
 }
 
+void ANNP_BitFryTestDemoCharacter::RotateControllerNow(float Yaw, float Pitch, float DeltaSeconds)
+{
+	APlayerController *playerController = Cast<APlayerController>(Controller);
+	FRotator rotation;
+	FRotator deltaRotation;
+	
+	// NNP: AddControllerYawInput only lands at the controller's next UpdateRotation,
+	// which runs before the pawn ticks, so a fixed step would move on last frame's
+	// facing.  Apply it the same way, scaled and pitch-limited, but now.  Like
+	// AddControllerYawInput, this does nothing for AI.
+	if(!playerController || !playerController->IsLocalPlayerController() || playerController->IsLookInputIgnored())
+		return;
+	
+	if(Yaw == 0.0f && Pitch == 0.0f)
+		return;
+	
+	rotation = playerController->GetControlRotation();
+	deltaRotation = FRotator(Pitch * playerController->InputPitchScale, Yaw * playerController->InputYawScale, 0.0f);
+	
+	if(playerController->PlayerCameraManager)
+		playerController->PlayerCameraManager->ProcessViewRotation(DeltaSeconds, rotation, deltaRotation);
+	else
+		rotation += deltaRotation;
+	
+	playerController->SetControlRotation(rotation);
+}
+
 void ANNP_BitFryTestDemoCharacter::MoveForward(float Value)
+{
+	if(bUseFixedTimestep)
+		PendingMoveForward = Value;
+	else
+		ApplyMoveForward(Value);
+	
+	UpdateHaptics();
+}
+
+void ANNP_BitFryTestDemoCharacter::ApplyMoveForward(float Value)
 {
 	if(NNPController && NNPController->IsInitialized())
 	{
@@ -233,11 +759,19 @@ void ANNP_BitFryTestDemoCharacter::MoveForward(float Value)
 		const FVector Direction = FRotationMatrix(YawRotation).GetUnitAxis(EAxis::X);
 		AddMovementInput(Direction, Value);
 	}
+}
+
+void ANNP_BitFryTestDemoCharacter::MoveRight(float Value)
+{
+	if(bUseFixedTimestep)
+		PendingMoveRight = Value;
+	else
+		ApplyMoveRight(Value);
 	
 	UpdateHaptics();
 }
 
-void ANNP_BitFryTestDemoCharacter::MoveRight(float Value)
+void ANNP_BitFryTestDemoCharacter::ApplyMoveRight(float Value)
 {
 	if(NNPController && NNPController->IsInitialized())
 	{
@@ -267,6 +801,4 @@ void ANNP_BitFryTestDemoCharacter::MoveRight(float Value)
 		// add movement in that direction
 		AddMovementInput(Direction, Value);
 	}
-	
-	UpdateHaptics();
 }
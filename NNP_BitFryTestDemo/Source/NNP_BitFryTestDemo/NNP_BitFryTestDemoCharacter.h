@@ -5,8 +5,17 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "NNPPlayerController.h"
+#include "NNPGestureRecognizer.h"
+#include "NNPHapticStreamer.h"
+#include "NNPFixedStepper.h"
+#include "NNPSurfaceQueryService.h"
 #include "NNP_BitFryTestDemoCharacter.generated.h"
 
+class UAudioComponent;
+class UNNPHapticEnvelopeAsset;
+class USoundBase;
+enum class EAudioComponentPlayState : uint8;
+
 UCLASS(config=Game)
 class ANNP_BitFryTestDemoCharacter : public ACharacter
 {
@@ -30,14 +39,82 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Camera)
 	float BaseLookUpRate;
 
+	/** Run input and movement at a fixed rate, independent of the render frame rate. */
+	UPROPERTY(EditAnywhere, Config, Category=Movement)
+	bool bUseFixedTimestep;
+
+	/** Simulation rate in fixed timestep mode, in steps per second. */
+	UPROPERTY(EditAnywhere, Config, Category=Movement, meta=(EditCondition="bUseFixedTimestep", ClampMin="10.0"))
+	float FixedTimestepRate;
+
+	/** Most full steps simulated in one frame.  Time still owed after a hitch is caught up in one longer step. */
+	UPROPERTY(EditAnywhere, Config, Category=Movement, meta=(EditCondition="bUseFixedTimestep", ClampMin="1"))
+	int32 MaxFixedSubSteps;
+
+	/**
+	 * Baked haptic envelopes loaded for the local player.  Each plays along with the sound it was baked from.
+	 * Empty until they are baked: run the NNPHapticBake commandlet, then list the HE_ assets it saves.
+	 */
+	UPROPERTY(EditAnywhere, Config, Category=Haptics, meta=(AllowedClasses="NNPHapticEnvelopeAsset"))
+	TArray<FSoftObjectPath> HapticEnvelopes;
+
 	void HandleButtons(NNPButtons button, bool pressed);
 	void DoNothing();
 	void UpdateHaptics();
 	
+	virtual void Tick(float DeltaSeconds) override;
+	
+	/** Controlled by a player on this machine.  IsLocallyControlled alone is also true for AI. */
+	bool IsLocalPlayer() const;
+	
+	/** Set by the significance manager: how often this character ticks, whether it ticks at all, and whether it must pose while unrendered. */
+	void ApplySignificance(bool dormant, float tickInterval, bool alwaysTickPose = false);
+	
+	/** Set by the surface query service when a query for this character completes. */
+	void ApplySurface(const FNNPSurfaceInfo& surface);
+	
+	/** What the character was standing on and walking towards when last queried. */
+	const FNNPSurfaceInfo& GetSurface() const;
+	
+	/** Play a sound at a location, and its haptic envelope on the local player's device if one was baked for it. */
+	UFUNCTION(BlueprintCallable, Category=Audio)
+	void PlaySoundWithHaptics(USoundBase *Sound, FVector Location);
+	
 protected:
 
 	ANNPPlayerController *NNPController;
 	
+	// NNP: Number of characters currently in play, for telemetry.
+	static int32 NumActiveCharacters;
+	
+	/** Write this frame's sample to the session telemetry ring. */
+	void RecordTelemetry(float DeltaSeconds);
+	
+	// NNP: Fixed timestep state.  Axis input is latched each frame and applied
+	// on every sub-step; the mesh and camera are drawn between the last two steps.
+	FNNPFixedStepper FixedStepper;
+	float PendingMoveForward;
+	float PendingMoveRight;
+	float PendingTurnRate;
+	float PendingLookUpRate;
+	FVector PreviousStepLocation;
+	FVector MeshBaseLocation;
+	
+	/** Tune skeletal mesh update rate optimizations when the mesh creates its parameters. */
+	void ConfigureAnimUpdateRate(struct FAnimUpdateRateParameters *params);
+	
+	/** Run as many fixed steps as the frame's time allows, then interpolate for rendering. */
+	void StepFixedTimestep(float DeltaSeconds);
+	
+	/** Movement and camera input for one step of the given length. */
+	void ApplyMoveForward(float Value);
+	void ApplyMoveRight(float Value);
+	void ApplyTurnAtRate(float Rate, float DeltaSeconds);
+	void ApplyLookUpAtRate(float Rate, float DeltaSeconds);
+	
+	/** Turn the controller right away, rather than at its next rotation update. */
+	void RotateControllerNow(float Yaw, float Pitch, float DeltaSeconds);
+	
 	/** Resets HMD orientation in VR. */
 	void OnResetVR();
 
@@ -65,11 +142,61 @@ protected:
 	/** Handler for when a touch input stops. */
 	void TouchStopped(ETouchIndex::Type FingerIndex, FVector Location);
 
+	/** Handler for when a touch input moves. */
+	void TouchMoved(ETouchIndex::Type FingerIndex, FVector Location);
+
+	// NNP: Touch gestures are recognized as samples arrive and handled once per frame from Tick.
+	FNNPGestureRecognizer Gestures;
+	bool bStopJumpingNextTick;
+	float DefaultArmLength;
+
+	/** Drain the gesture queue. */
+	void ProcessGestures();
+
+	/** React to a single recognized gesture. */
+	void HandleGesture(const GestureEvent& event);
+
+	// NNP: Last surface query result.  Drives the walking haptics.
+	FNNPSurfaceInfo Surface;
+
+	// NNP: Envelopes are loaded once for the local player and streamed to the controller from Tick.
+	UPROPERTY(Transient)
+	TArray<UNNPHapticEnvelopeAsset*> LoadedHapticEnvelopes;
+	FNNPHapticStreamer HapticStreamer;
+
+	void LoadHapticEnvelopes();
+
+	/** The envelope baked for a wave, or for the first wave in a cue that has one. */
+	const UNNPHapticEnvelopeAsset* FindHapticEnvelope(USoundBase *sound) const;
+
+	/** Start an envelope on the local player's device, fading with distance to where the sound plays. */
+	void PlayHapticEnvelope(const UNNPHapticEnvelopeAsset *envelope, FVector location);
+
+	// NNP: Sounds the world plays through audio components, such as the starter content
+	// effects, are followed so their envelopes stream too.
+	TArray<TWeakObjectPtr<UAudioComponent>> HookedAudioComponents;
+	FDelegateHandle ActorSpawnedHandle;
+
+	void HookAudioComponents();
+	void HookActorAudio(AActor *actor);
+	void UnhookAudioComponents();
+	void OnAudioPlayStateChanged(const UAudioComponent *component, EAudioComponentPlayState state);
+
 protected:
 	// APawn interface
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
+	virtual void Restart() override;
+	virtual void UnPossessed() override;
 	// End of APawn interface
 
+	/** Only the local player uses surface queries, so only it is registered for them. */
+	void UpdateSurfaceQueryRegistration();
+
+	// AActor interface
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	// End of AActor interface
+
 public:
 	/** Returns CameraBoom subobject **/
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
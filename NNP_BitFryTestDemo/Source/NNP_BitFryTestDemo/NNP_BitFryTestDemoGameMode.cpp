@@ -1,10 +1,49 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "NNP_BitFryTestDemoGameMode.h"
+#include "NNP_BitFryTestDemo.h"
 #include "NNP_BitFryTestDemoCharacter.h"
+#include "NNPSignificanceManager.h"
+#include "NNPSurfaceQueryService.h"
+#include "HAL/IConsoleManager.h"
+#include "RenderCore.h"
+#include "Sound/SoundBase.h"
 #include "UObject/ConstructorHelpers.h"
 
-ANNP_BitFryTestDemoGameMode::ANNP_BitFryTestDemoGameMode()
+// NNP: What each governor level trades away.  Level 0 matches DefaultEngine.ini.
+struct FNNPScalabilityLevel
+{
+	float ScreenPercentage;
+	int32 MaxMobileCascades;
+	float EmitterSpawnRateScale;
+	float CharacterTickInterval;
+};
+
+static const FNNPScalabilityLevel ScalabilityLevels[] =
+{
+	{ 100.0f, 2, 1.0f,  0.0f },
+	{  85.0f, 2, 0.75f, 1.0f / 30.0f },
+	{  70.0f, 1, 0.5f,  1.0f / 20.0f },
+	{  55.0f, 0, 0.25f, 1.0f / 10.0f },
+};
+
+static void SetConsoleVariable(const TCHAR *name, float value)
+{
+	IConsoleVariable *variable = IConsoleManager::Get().FindConsoleVariable(name);
+
+	if(variable)
+		variable->Set(value, ECVF_SetByCode);
+}
+
+static FNNPGovernorSettings MakeGovernorSettings()
+{
+	FNNPGovernorSettings settings;
+
+	settings.MaxLevel = UE_ARRAY_COUNT(ScalabilityLevels) - 1;
+	return settings;
+}
+
+ANNP_BitFryTestDemoGameMode::ANNP_BitFryTestDemoGameMode() : Governor(MakeGovernorSettings())
 {
 	// set default pawn class to our Blueprinted character
 	static ConstructorHelpers::FClassFinder<APawn> PlayerPawnBPClass(TEXT("/Game/ThirdPersonCPP/Blueprints/ThirdPersonCharacter"));
@@ -12,4 +51,117 @@ ANNP_BitFryTestDemoGameMode::ANNP_BitFryTestDemoGameMode()
 	{
 		DefaultPawnClass = PlayerPawnBPClass.Class;
 	}
+
+	PrimaryActorTick.bCanEverTick = true;
+
+	bEnableScalabilityGovernor = false;
+	TargetFrameTimeMs = 1000.0f / 60.0f;
+	SignificanceManager = nullptr;
+}
+
+void ANNP_BitFryTestDemoGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	// NNP: Spawned before anything begins play so every character can register with them.
+	FActorSpawnParameters params;
+	params.Instigator = GetInstigator();
+	params.ObjectFlags |= RF_Transient;
+	SignificanceManager = GetWorld()->SpawnActor<ANNPSignificanceManager>(params);
+	SurfaceQueryService = GetWorld()->SpawnActor<ANNPSurfaceQueryService>(params);
+}
+
+ANNPSignificanceManager* ANNP_BitFryTestDemoGameMode::GetSignificanceManager() const
+{
+	return SignificanceManager;
+}
+
+ANNPSurfaceQueryService* ANNP_BitFryTestDemoGameMode::GetSurfaceQueryService() const
+{
+	return SurfaceQueryService;
+}
+
+void ANNP_BitFryTestDemoGameMode::NNPBenchmarkCrowd(int32 Count, int32 Frames)
+{
+	if(SignificanceManager)
+		SignificanceManager->StartBenchmark(Count, Frames);
+}
+
+void ANNP_BitFryTestDemoGameMode::NNPPlaySound(const FString& Sound)
+{
+	APlayerController *player = GetWorld()->GetFirstPlayerController();
+	ANNP_BitFryTestDemoCharacter *character = player ? Cast<ANNP_BitFryTestDemoCharacter>(player->GetPawn()) : nullptr;
+	FString path = Sound;
+	USoundBase *sound;
+
+	if(!path.StartsWith(TEXT("/")))
+		path = FString::Printf(TEXT("/Game/MobileStarterContent/Audio/%s.%s"), *Sound, *Sound);
+
+	sound = LoadObject<USoundBase>(nullptr, *path);
+	if(!character || !sound)
+	{
+		UE_LOG(LogNNP, Warning, TEXT("NNPPlaySound: no player character or no sound at %s"), *path);
+		return;
+	}
+
+	character->PlaySoundWithHaptics(sound, character->GetActorLocation());
+}
+
+void ANNP_BitFryTestDemoGameMode::NNPBenchmarkSurfaceQueries(int32 Count, int32 Frames)
+{
+	if(!SignificanceManager || !SurfaceQueryService)
+		return;
+
+	SignificanceManager->SpawnCrowd(Count);
+	SurfaceQueryService->StartBenchmark(Frames);
+}
+
+void ANNP_BitFryTestDemoGameMode::BeginPlay()
+{
+	Super::BeginPlay();
+
+	FNNPGovernorSettings settings = MakeGovernorSettings();
+	settings.TargetFrameTimeMs = TargetFrameTimeMs;
+	Governor = FNNPScalabilityGovernor(settings);
+
+	// NNP: Editor hitches aren't the device running out of headroom, so PIE never scales.
+	if(GIsEditor)
+		bEnableScalabilityGovernor = false;
+
+	SetActorTickEnabled(bEnableScalabilityGovernor);
+}
+
+void ANNP_BitFryTestDemoGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if(!bEnableScalabilityGovernor)
+		return;
+
+	if(Governor.Sample(DeltaSeconds * 1000.0f, FPlatformTime::ToMilliseconds(GGameThreadTime)))
+		ApplyScalabilityLevel(Governor.GetLevel());
+}
+
+float ANNP_BitFryTestDemoGameMode::GetCharacterTickInterval() const
+{
+	return ScalabilityLevels[Governor.GetLevel()].CharacterTickInterval;
+}
+
+int32 ANNP_BitFryTestDemoGameMode::GetScalabilityLevel() const
+{
+	return Governor.GetLevel();
+}
+
+void ANNP_BitFryTestDemoGameMode::ApplyScalabilityLevel(int32 level)
+{
+	const FNNPScalabilityLevel& settings = ScalabilityLevels[level];
+
+	UE_LOG(LogNNP, Log, TEXT("Scalability governor: level %d (frame %.2f ms, game thread %.2f ms)"),
+		level, Governor.GetSmoothedFrameTimeMs(), Governor.GetSmoothedGameThreadTimeMs());
+
+	SetConsoleVariable(TEXT("r.ScreenPercentage"), settings.ScreenPercentage);
+	SetConsoleVariable(TEXT("r.Shadow.CSM.MaxMobileCascades"), settings.MaxMobileCascades);
+	SetConsoleVariable(TEXT("r.EmitterSpawnRateScale"), settings.EmitterSpawnRateScale);
+
+	// Character tick rates are picked up by the significance manager on its next sweep.
 }
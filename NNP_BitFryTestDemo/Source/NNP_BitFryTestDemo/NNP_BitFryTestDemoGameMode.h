@@ -4,16 +4,65 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
+#include "NNPScalabilityGovernor.h"
 #include "NNP_BitFryTestDemoGameMode.generated.h"
 
-UCLASS(minimalapi)
+class ANNPSignificanceManager;
+class ANNPSurfaceQueryService;
+
+UCLASS(minimalapi, config=Game)
 class ANNP_BitFryTestDemoGameMode : public AGameModeBase
 {
 	GENERATED_BODY()
 
 public:
 	ANNP_BitFryTestDemoGameMode();
-};
 
+	virtual void Tick(float DeltaSeconds) override;
+
+	/** Step scalability up and down at runtime to hold the target frame time.  Enabled per platform in config; never in the editor. */
+	UPROPERTY(EditAnywhere, Config, Category = Scalability)
+	bool bEnableScalabilityGovernor;
+
+	/** Frame time the governor tries to hold, in ms.  Matches the 60 fps frame rate lock by default. */
+	UPROPERTY(EditAnywhere, Config, Category = Scalability)
+	float TargetFrameTimeMs;
+
+	/** Tick interval for characters other than the local player at the current scalability level. */
+	float GetCharacterTickInterval() const;
+
+	/** The governor's current scalability level.  0 is full quality. */
+	int32 GetScalabilityLevel() const;
+
+	ANNPSignificanceManager* GetSignificanceManager() const;
+
+	ANNPSurfaceQueryService* GetSurfaceQueryService() const;
 
+	/** Spawn Count AI characters and log game-thread time with and without significance. */
+	UFUNCTION(Exec)
+	void NNPBenchmarkCrowd(int32 Count, int32 Frames = 300);
 
+	/** Play a sound on the player with its haptic envelope.  Takes an object path or a starter content audio name. */
+	UFUNCTION(Exec)
+	void NNPPlaySound(const FString& Sound);
+
+	/** Spawn Count AI characters and log surface query cost for sync, async and cached async traces.  Runs headless with -nullrhi. */
+	UFUNCTION(Exec)
+	void NNPBenchmarkSurfaceQueries(int32 Count = 500, int32 Frames = 300);
+
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
+protected:
+	virtual void BeginPlay() override;
+
+	UPROPERTY(Transient)
+	ANNPSignificanceManager *SignificanceManager;
+
+	UPROPERTY(Transient)
+	ANNPSurfaceQueryService *SurfaceQueryService;
+
+	// NNP: Push the settings for the governor's current level to the engine.
+	void ApplyScalabilityLevel(int32 level);
+
+	FNNPScalabilityGovernor Governor;
+};